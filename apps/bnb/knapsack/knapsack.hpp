@@ -1,37 +1,35 @@
 #ifndef KNAPSACK_HPP
 #define KNAPSACK_HPP
 
-#include <vector>
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
 
 #include <hpx/config.hpp>
 #include <boost/serialization/access.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
 
 #include <hpx/util/tuple.hpp>
 
 #include "util/NodeGenerator.hpp"
 
-/* A representation of a knapsack current solution */
-struct KPSolution {
-  std::vector<int> items;
-  int profit;
-  int weight;
-
-  template <class Archive>
-  void serialize(Archive & ar, const unsigned int version) {
-    ar & items;
-    ar & profit;
-    ar & weight;
-  }
-};
-
-template <unsigned N>
+// Items are stored flat at the size of the instance; only nodes are sized
+// at compile time (see KPNode)
 struct KPSpace {
-  std::array<int, N> profits;
-  std::array<int, N> weights;
+  std::vector<int> profits;
+  std::vector<int> weights;
   int numItems;
   int capacity;
+  // Use the Martello-Toth bound rather than Dantzig's
+  bool martelloToth;
+  // profitSum[i] (weightSum[i]) is the total profit (weight) of items 0..i-1,
+  // filled in by makeSpace
+  std::vector<int> profitSum;
+  std::vector<int> weightSum;
 
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
@@ -39,76 +37,285 @@ struct KPSpace {
     ar & weights;
     ar & numItems;
     ar & capacity;
+    ar & martelloToth;
+    ar & profitSum;
+    ar & weightSum;
   }
 };
 
+inline KPSpace makeSpace(const std::vector<int> & profits, const std::vector<int> & weights,
+                         int capacity, bool martelloToth) {
+  int numItems = profits.size();
+  KPSpace space {profits, weights, numItems, capacity, martelloToth};
+  space.profitSum.assign(numItems + 1, 0);
+  space.weightSum.assign(numItems + 1, 0);
+  for (auto i = 0; i < numItems; i++) {
+    space.profitSum[i + 1] = space.profitSum[i] + profits[i];
+    space.weightSum[i + 1] = space.weightSum[i] + weights[i];
+  }
+  return space;
+}
+
+// The space restricted to the given items (kept in the same order)
+inline KPSpace subSpace(const KPSpace & space, const std::vector<int> & items) {
+  std::vector<int> profits;
+  std::vector<int> weights;
+  for (auto i : items) {
+    profits.push_back(space.profits[i]);
+    weights.push_back(space.weights[i]);
+  }
+  return makeSpace(profits, weights, space.capacity, space.martelloToth);
+}
+
+/* A node of the search: the items taken so far as a bitset along with their
+ * profit and weight. Nodes are a fixed size so generating children never
+ * allocates, with the number of 64 bit words in the bitset picked at runtime
+ * from the number of items. */
+template <unsigned n_words_>
 struct KPNode {
-  KPSolution sol;
-  std::vector<int> rem;
+  std::array<std::uint64_t, n_words_> items;
+  int profit;
+  int weight;
+  // Children take items from here on
+  int next;
+  // Bound on the profit of any descendant, computed by the generator
+  int bound;
 
   int getObj() const {
-    return sol.profit;
+    return profit;
+  }
+
+  bool taken(int i) const {
+    return items[i / 64] & (std::uint64_t{1} << (i % 64));
+  }
+
+  void take(int i) {
+    items[i / 64] |= (std::uint64_t{1} << (i % 64));
   }
 
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
-    ar & sol;
-    ar & rem;
+    ar & items;
+    ar & profit;
+    ar & weight;
+    ar & next;
+    ar & bound;
   }
 };
 
-template <unsigned numItems>
-struct GenNode : YewPar::NodeGenerator<KPNode, KPSpace<numItems> > {
-  std::vector<int> items;
-  int pos;
+// Both bounds fill the remaining capacity greedily from item `from` (items
+// are in profit density order) up to the critical item, the first that
+// doesn't fit. The prefix sums let us find it with a binary search.
+inline int criticalItem(const KPSpace & space, int from, int weight) {
+  auto first = space.weightSum.begin() + from + 1;
+  auto last  = space.weightSum.begin() + space.numItems + 1;
+  auto limit = space.weightSum[from] + space.capacity - weight;
+  return std::upper_bound(first, last, limit) - space.weightSum.begin() - 1;
+}
 
-  std::reference_wrapper<const KPSpace<numItems> > space;
-  std::reference_wrapper<const KPNode> n;
+// Dantzig bound: the greedy fill plus a fraction of the critical item
+inline int dantzigBound(const KPSpace & space, int from, int profit, int weight) {
+  auto s = criticalItem(space, from, weight);
+  double p = profit + space.profitSum[s] - space.profitSum[from];
+  if (s < space.numItems) {
+    auto residual = space.capacity - weight - (space.weightSum[s] - space.weightSum[from]);
+    p = p + residual * ((double) space.profits[s] / (double) space.weights[s]);
+  }
+  return std::ceil(p);
+}
 
-  GenNode (const KPSpace<numItems> & space, const KPNode & n) :
-      pos(0), space(std::cref(space)), n(std::cref(n)) {
-    this->numChildren = n.rem.size();
+// Martello-Toth bound: the critical item is either left out, and the residual
+// capacity filled at the density of the item after it, or taken, making room
+// by removing weight at the density of the item before it. Computed in
+// integers since profits are, which also makes it at least as tight as
+// Dantzig's.
+inline int martelloTothBound(const KPSpace & space, int from, int profit, int weight) {
+  auto s = criticalItem(space, from, weight);
+  long p = profit + space.profitSum[s] - space.profitSum[from];
+  if (s == space.numItems) {
+    return p;
   }
 
-  KPNode next() override {
-    auto i = n.get().rem[pos];
-    auto newSol = n.get().sol;
-    newSol.items.push_back(i);
-    newSol.profit += space.get().profits[i];
-    newSol.weight += space.get().weights[i];
+  long residual = space.capacity - weight - (space.weightSum[s] - space.weightSum[from]);
+  auto without = p;
+  if (s + 1 < space.numItems) {
+    without += residual * space.profits[s + 1] / space.weights[s + 1];
+  }
 
-    ++pos;
+  // Nothing to remove if the critical item is the first available
+  auto with = without;
+  if (s > from) {
+    long excess = space.weights[s] - residual;
+    with = p + space.profits[s] - (excess * space.profits[s - 1] + space.weights[s - 1] - 1) / space.weights[s - 1];
+  }
 
-    std::vector<int> newRem;
-    std::copy_if(n.get().rem.begin() + pos, n.get().rem.end(), std::back_inserter(newRem),
-                 [&](const int i) {
-                   return newSol.weight + space.get().weights[i] <= space.get().capacity;
-                 });
+  return std::max(without, with);
+}
 
-    return { newSol, std::move(newRem) };
-  }
+inline int childBound(const KPSpace & space, int from, int profit, int weight) {
+  return space.martelloToth ? martelloTothBound(space, from, profit, weight)
+                            : dantzigBound(space, from, profit, weight);
+}
+
+// Root reduction: using the greedy solution as a lower bound, leave out items
+// that can't be in any solution at least as good and fix items that every
+// such solution takes. Every optimal solution is kept, so only the remaining
+// free items need searching.
+struct KPReduction {
+  std::vector<int> fixed;
+  std::vector<int> free;
 };
 
-template <unsigned numItems>
-int upperBound(const KPSpace<numItems> & space, const KPNode & n) {
-  auto sol = n.sol;
+inline KPReduction reduce(const KPSpace & space) {
+  int lowerBound = 0;
+  int w = 0;
+  for (auto i = 0; i < space.numItems; i++) {
+    if (w + space.weights[i] <= space.capacity) {
+      lowerBound += space.profits[i];
+      w += space.weights[i];
+    }
+  }
 
-  double profit = sol.profit;
-  auto weight  = sol.weight;
+  // Dantzig bound with item j forced in or out. Only used at the root so a
+  // linear scan is fine.
+  auto boundWith = [&](int j, bool taken) {
+    double profit = taken ? space.profits[j] : 0;
+    int weight = taken ? space.weights[j] : 0;
+    for (auto i = 0; i < space.numItems; i++) {
+      if (i == j) {
+        continue;
+      }
+      if (weight + space.weights[i] <= space.capacity) {
+        profit += space.profits[i];
+        weight += space.weights[i];
+      } else {
+        profit = profit + (space.capacity - weight) * ((double) space.profits[i] / (double) space.weights[i]);
+        break;
+      }
+    }
+    return std::floor(profit);
+  };
 
-  for (auto i = sol.items.back() + 1; i < space.numItems; i++) {
-    // If there is enough space for a full item we take it all
-    if (space.weights[i] + weight <= space.capacity) {
-      profit += space.profits[i];
-      weight += space.weights[i];
+  KPReduction r;
+  for (auto j = 0; j < space.numItems; j++) {
+    if (space.weights[j] > space.capacity || boundWith(j, true) < lowerBound) {
+      continue;
+    } else if (boundWith(j, false) < lowerBound) {
+      r.fixed.push_back(j);
     } else {
-      // Only space for some fraction of the last item
-      profit = profit + (space.capacity - weight) * ((double) space.profits[i] / (double) space.weights[i]);
-      break;
+      r.free.push_back(j);
+    }
+  }
+  return r;
+}
+
+template <unsigned n_words_>
+KPNode<n_words_> rootNode(const KPSpace & space, int profit = 0, int weight = 0) {
+  KPNode<n_words_> root {{}, profit, weight, 0, 0};
+  root.bound = childBound(space, 0, profit, weight);
+  return root;
+}
+
+// The children of a node take one more of the later items that still fit.
+// Every ancestor weighs no more than the node, so checking against the node's
+// weight alone gives the items that are still possible without keeping a list.
+template <unsigned n_words_>
+struct GenNode : YewPar::NodeGenerator<KPNode<n_words_>, KPSpace> {
+  std::reference_wrapper<const KPSpace> space;
+  std::reference_wrapper<const KPNode<n_words_> > n;
+  int pos;
+
+  GenNode (const KPSpace & space, const KPNode<n_words_> & n) :
+      space(std::cref(space)), n(std::cref(n)), pos(n.next) {
+    this->numChildren = 0;
+    for (auto i = n.next; i < space.numItems; i++) {
+      if (n.weight + space.weights[i] <= space.capacity) {
+        ++this->numChildren;
+      }
+    }
+  }
+
+  KPNode<n_words_> next() override {
+    const auto & s = space.get();
+    const auto & parent = n.get();
+    while (parent.weight + s.weights[pos] > s.capacity) {
+      ++pos;
+    }
+
+    auto child = parent;
+    child.take(pos);
+    child.profit += s.profits[pos];
+    child.weight += s.weights[pos];
+    child.next = pos + 1;
+    child.bound = childBound(s, child.next, child.profit, child.weight);
+    // Level pruning skips the later siblings once a child's bound fails, so
+    // it must cover them too: they are the parent using items after pos.
+    // Dantzig's bound always does as the items are in density order, the
+    // Martello-Toth bound needn't.
+    if (s.martelloToth) {
+      child.bound = std::max(child.bound, martelloTothBound(s, pos + 1, parent.profit, parent.weight));
+    }
+
+    ++pos;
+    return child;
+  }
+};
+
+template <unsigned n_words_>
+int upperBound(const KPSpace & space, const KPNode<n_words_> & n) {
+  return n.bound;
+}
+
+// Warm start heuristic: greedy in density order from the root, skipping each
+// item with probability 1/8 so repeated runs differ (the first run of each
+// worker, with the low 32 bits of the seed zero, is plain greedy), then local
+// search swapping a taken item for a more profitable one or adding any item
+// that fits until neither improves. The node is only used as an incumbent.
+template <unsigned n_words_>
+KPNode<n_words_> warmStartHeuristic(const KPSpace & space, const KPNode<n_words_> & root, std::uint64_t seed) {
+  std::mt19937_64 rand(seed);
+  auto randomised = (seed & 0xffffffff) != 0;
+
+  auto n = root;
+  for (auto i = root.next; i < space.numItems; i++) {
+    if (n.weight + space.weights[i] <= space.capacity && !(randomised && rand() % 8 == 0)) {
+      n.take(i);
+      n.profit += space.profits[i];
+      n.weight += space.weights[i];
+    }
+  }
+
+  auto improved = true;
+  while (improved) {
+    improved = false;
+    for (auto i = root.next; i < space.numItems && !improved; i++) {
+      if (n.taken(i)) {
+        continue;
+      }
+      if (n.weight + space.weights[i] <= space.capacity) {
+        n.take(i);
+        n.profit += space.profits[i];
+        n.weight += space.weights[i];
+        improved = true;
+        continue;
+      }
+      for (auto j = root.next; j < space.numItems; j++) {
+        if (n.taken(j) && space.profits[i] > space.profits[j] &&
+            n.weight - space.weights[j] + space.weights[i] <= space.capacity) {
+          n.items[j / 64] &= ~(std::uint64_t{1} << (j % 64));
+          n.take(i);
+          n.profit += space.profits[i] - space.profits[j];
+          n.weight += space.weights[i] - space.weights[j];
+          improved = true;
+          break;
+        }
+      }
     }
   }
 
-  return std::ceil(profit);
+  n.next = space.numItems;
+  n.bound = n.profit;
+  return n;
 }
 
 #endif
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <numeric>
 #include <string>
+#include <vector>
 #include <regex>
 #include <exception>
 #include <chrono>
@@ -19,11 +21,19 @@
 #include "skeletons/Budget.hpp"
 #include "skeletons/StackStealing.hpp"
 
-#ifndef NUMITEMS
-#define NUMITEMS 50
+// Largest number of 64 bit words in the node bitsets. Instances are searched
+// with the smallest power of two number of words (or NWORDS) that fits their
+// items, chosen at runtime. Possible to specify at compile time to handle
+// bigger instances if required
+#ifndef NWORDS
+#define NWORDS 16
 #endif
 
-typedef func<decltype(&upperBound<NUMITEMS>), &upperBound<NUMITEMS> > bnd_func;
+template <unsigned n_words_>
+using bnd_func = func<decltype(&upperBound<n_words_>), &upperBound<n_words_> >;
+
+template <unsigned n_words_>
+using warmStart_func = func<decltype(&warmStartHeuristic<n_words_>), &warmStartHeuristic<n_words_> >;
 
 struct knapsackData {
   int capacity = 0;
@@ -66,6 +76,119 @@ knapsackData read_knapsack(const std::string & filename) {
   return kp;
 }
 
+// The instance to search: the items left free by the root reduction (all of
+// them without it) as a space, plus the items it fixed
+struct Instance {
+  KPSpace space;
+  std::vector<int> fixedItems;
+  // Index in the sorted items of each item in the space
+  std::vector<int> freeItems;
+  int fixedProfit;
+  int fixedWeight;
+  int expectedResult;
+  std::chrono::steady_clock::time_point startTime;
+};
+
+template <unsigned n_words_>
+int search(const Instance & inst, boost::program_options::variables_map & opts) {
+  using bnd_func = ::bnd_func<n_words_>;
+  using warmStart_func = ::warmStart_func<n_words_>;
+  const auto & space = inst.space;
+  auto root = rootNode<n_words_>(space, inst.fixedProfit, inst.fixedWeight);
+
+  YewPar::Skeletons::API::Params<int> searchParameters;
+  searchParameters.warmStartTime = opts["warm-start-time"].as<unsigned>();
+
+  auto sol = root;
+  auto skeletonType = opts["skeleton"].as<std::string>();
+  if (skeletonType == "seq") {
+    sol = YewPar::Skeletons::Seq<GenNode<n_words_>,
+                                 YewPar::Skeletons::API::Optimisation,
+                                 YewPar::Skeletons::API::PruneLevel,
+                                 YewPar::Skeletons::API::BoundFunction<bnd_func>,
+                                 YewPar::Skeletons::API::WarmStart<warmStart_func> >
+          ::search(space, root, searchParameters);
+  } else if (skeletonType == "depthbounded") {
+    auto spawnDepth = opts["spawn-depth"].as<unsigned>();
+    searchParameters.spawnDepth = spawnDepth;
+    sol = YewPar::Skeletons::DepthBounded<GenNode<n_words_>,
+                                         YewPar::Skeletons::API::Optimisation,
+                                         YewPar::Skeletons::API::PruneLevel,
+                                         YewPar::Skeletons::API::BoundFunction<bnd_func>,
+                                         YewPar::Skeletons::API::WarmStart<warmStart_func> >
+          ::search(space, root, searchParameters);
+  } else if (skeletonType == "ordered") {
+    auto spawnDepth = opts["spawn-depth"].as<unsigned>();
+    searchParameters.spawnDepth = spawnDepth;
+    sol = YewPar::Skeletons::Ordered<GenNode<n_words_>,
+                                     YewPar::Skeletons::API::Optimisation,
+                                     YewPar::Skeletons::API::PruneLevel,
+                                     YewPar::Skeletons::API::BoundFunction<bnd_func>,
+                                     YewPar::Skeletons::API::WarmStart<warmStart_func> >
+          ::search(space, root, searchParameters);
+  } else if (skeletonType == "budget") {
+    searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
+    sol = YewPar::Skeletons::Budget<GenNode<n_words_>,
+                                    YewPar::Skeletons::API::Optimisation,
+                                    YewPar::Skeletons::API::PruneLevel,
+                                    YewPar::Skeletons::API::BoundFunction<bnd_func>,
+                                    YewPar::Skeletons::API::WarmStart<warmStart_func> >
+        ::search(space, root, searchParameters);
+  } else if (skeletonType == "stacksteal") {
+    searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
+    sol = YewPar::Skeletons::StackStealing<GenNode<n_words_>,
+                                           YewPar::Skeletons::API::Optimisation,
+                                           YewPar::Skeletons::API::PruneLevel,
+                                           YewPar::Skeletons::API::BoundFunction<bnd_func>,
+                                           YewPar::Skeletons::API::WarmStart<warmStart_func> >
+        ::search(space, root, searchParameters);
+  } else {
+    hpx::cout << "Invalid skeleton type\n";
+    hpx::finalize();
+    return EXIT_FAILURE;
+  }
+
+  auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
+                      (std::chrono::steady_clock::now() - inst.startTime);
+
+  hpx::cout << "Final Profit: " << sol.profit << hpx::endl;
+  hpx::cout << "Final Weight: " << sol.weight << hpx::endl;
+  hpx::cout << "Expected Result: " << std::boolalpha << (sol.profit == inst.expectedResult) << hpx::endl;
+  auto items = inst.fixedItems;
+  for (int i = 0; i < space.numItems; i++) {
+    if (sol.taken(i)) {
+      items.push_back(inst.freeItems[i]);
+    }
+  }
+  std::sort(items.begin(), items.end());
+  hpx::cout << "Items: ";
+  for (auto const & i : items) {
+    hpx::cout << i << " ";
+  }
+  hpx::cout << hpx::endl;
+
+  hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
+
+  return hpx::finalize();
+}
+
+// Search with the smallest size class that fits the items left to search,
+// doubling up to NWORDS
+template <unsigned n_words_>
+int searchSizeClass(const Instance & inst, boost::program_options::variables_map & opts) {
+  if (inst.space.numItems <= n_words_ * 64) {
+    return search<n_words_>(inst, opts);
+  }
+
+  if constexpr (n_words_ < NWORDS) {
+    return searchSizeClass<std::min(n_words_ * 2, static_cast<unsigned>(NWORDS))>(inst, opts);
+  } else {
+    hpx::cout << "Binary Cannot Handle Instance of this size. Recompile with a bigger NWORDS" << hpx::endl;
+    hpx::finalize();
+    return EXIT_FAILURE;
+  }
+}
+
 int hpx_main(boost::program_options::variables_map & opts) {
 
 
@@ -97,17 +220,11 @@ int hpx_main(boost::program_options::variables_map & opts) {
             });
 
   // Pack the problem into a more efficient format
-  std::array<int, NUMITEMS> profits;
-  std::array<int, NUMITEMS> weights;
-  int i = 0;
+  std::vector<int> profits;
+  std::vector<int> weights;
   for (auto const & item : problem.items) {
-    int profit = std::get<0>(item);
-    int weight = std::get<1>(item);
-
-    profits[i] = profit;
-    weights[i] = weight;
-
-    i++;
+    profits.push_back(std::get<0>(item));
+    weights.push_back(std::get<1>(item));
   }
 
   int numItems = problem.items.size();
@@ -125,79 +242,33 @@ int hpx_main(boost::program_options::variables_map & opts) {
 
   auto start_time = std::chrono::steady_clock::now();
 
-  KPSpace<NUMITEMS> space {profits, weights, numItems, problem.capacity};
-  KPSolution initSol = {std::vector<int>(), 0, 0};
-
-  std::vector<int> initRem;
-  for (int i = 0; i < numItems; i++) {
-    initRem.push_back(i);
-  }
-  KPNode root {initSol, initRem};
-
-  auto sol = root;
-  auto skeletonType = opts["skeleton"].as<std::string>();
-  if (skeletonType == "seq") {
-    sol = YewPar::Skeletons::Seq<GenNode<NUMITEMS>,
-                                 YewPar::Skeletons::API::Optimisation,
-                                 YewPar::Skeletons::API::PruneLevel,
-                                 YewPar::Skeletons::API::BoundFunction<bnd_func> >
-          ::search(space, root);
-  } else if (skeletonType == "depthbounded") {
-    auto spawnDepth = opts["spawn-depth"].as<unsigned>();
-    YewPar::Skeletons::API::Params<int> searchParameters;
-    searchParameters.spawnDepth = spawnDepth;
-    sol = YewPar::Skeletons::DepthBounded<GenNode<NUMITEMS>,
-                                         YewPar::Skeletons::API::Optimisation,
-                                         YewPar::Skeletons::API::PruneLevel,
-                                         YewPar::Skeletons::API::BoundFunction<bnd_func> >
-          ::search(space, root, searchParameters);
-  } else if (skeletonType == "ordered") {
-    auto spawnDepth = opts["spawn-depth"].as<unsigned>();
-    YewPar::Skeletons::API::Params<int> searchParameters;
-    searchParameters.spawnDepth = spawnDepth;
-    sol = YewPar::Skeletons::Ordered<GenNode<NUMITEMS>,
-                                     YewPar::Skeletons::API::Optimisation,
-                                     YewPar::Skeletons::API::PruneLevel,
-                                     YewPar::Skeletons::API::BoundFunction<bnd_func> >
-          ::search(space, root, searchParameters);
-  } else if (skeletonType == "budget") {
-    YewPar::Skeletons::API::Params<int> searchParameters;
-    searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
-    sol = YewPar::Skeletons::Budget<GenNode<NUMITEMS>,
-                                    YewPar::Skeletons::API::Optimisation,
-                                    YewPar::Skeletons::API::PruneLevel,
-                                    YewPar::Skeletons::API::BoundFunction<bnd_func> >
-        ::search(space, root, searchParameters);
-  } else if (skeletonType == "stacksteal") {
-    YewPar::Skeletons::API::Params<int> searchParameters;
-    searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
-    sol = YewPar::Skeletons::StackStealing<GenNode<NUMITEMS>,
-                                           YewPar::Skeletons::API::Optimisation,
-                                           YewPar::Skeletons::API::PruneLevel,
-                                           YewPar::Skeletons::API::BoundFunction<bnd_func> >
-        ::search(space, root, searchParameters);
-  } else {
-    hpx::cout << "Invalid skeleton type\n";
+  auto boundType = opts["bound"].as<std::string>();
+  if (boundType != "dantzig" && boundType != "mt") {
+    hpx::cout << "Invalid bound type\n";
     hpx::finalize();
     return EXIT_FAILURE;
   }
-
-  auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
-                      (std::chrono::steady_clock::now() - start_time);
-
-  auto finalSol = sol.sol;
-  hpx::cout << "Final Profit: " << finalSol.profit << hpx::endl;
-  hpx::cout << "Final Weight: " << finalSol.weight << hpx::endl;
-  hpx::cout << "Expected Result: " << std::boolalpha << (finalSol.profit == problem.expectedResult) << hpx::endl;
-  hpx::cout << "Items: ";
-  for (auto const & i : finalSol.items) {
-    hpx::cout << i << " ";
+  auto space = makeSpace(profits, weights, problem.capacity, boundType == "mt");
+
+  // Search only the items the reduction leaves free (indices into the
+  // original items), starting with the fixed ones taken
+  std::vector<int> fixedItems;
+  std::vector<int> freeItems(numItems);
+  std::iota(freeItems.begin(), freeItems.end(), 0);
+  if (opts.count("reduce")) {
+    auto reduction = reduce(space);
+    fixedItems = reduction.fixed;
+    freeItems = reduction.free;
+    space = subSpace(space, freeItems);
   }
-  hpx::cout << hpx::endl;
 
-  hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
+  Instance inst {space, fixedItems, freeItems, 0, 0, problem.expectedResult, start_time};
+  for (auto i : fixedItems) {
+    inst.fixedProfit += profits[i];
+    inst.fixedWeight += weights[i];
+  }
 
-  return hpx::finalize();
+  return searchSizeClass<1>(inst, opts);
 }
 
 int main(int argc, char* argv[]) {
@@ -218,6 +289,15 @@ int main(int argc, char* argv[]) {
       "Number of backtracks before spawning work"
     )
     ("chunked", "Use chunking with stack stealing")
+    ( "bound",
+      boost::program_options::value<std::string>()->default_value("dantzig"),
+      "Bound function: dantzig or mt (Martello-Toth)"
+    )
+    ("reduce", "Fix items at the root that every optimal solution does or doesn't take")
+    ( "warm-start-time",
+      boost::program_options::value<unsigned>()->default_value(0),
+      "Time (ms) to run the greedy/local search heuristic on every worker for an initial incumbent"
+    )
     ( "spawn-depth,d",
       boost::program_options::value<unsigned>()->default_value(0),
       "Depth in the tree to spawn until (for parallel skeletons only)"
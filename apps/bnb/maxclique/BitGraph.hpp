@@ -4,12 +4,21 @@
 /**
  * Bitset-encoded graph, using a fixed number of words which is selected at
  * compile time.
+ *
+ * The rows are either owned, or a view of rows stored elsewhere (e.g. a
+ * mapped graph cache, see util/GraphCache.hpp) that is kept alive by a shared
+ * pointer for as long as any copy of the graph exists. Serialising a view
+ * sends the rows, so remote copies always own theirs.
  */
 
 #include "BitSet.hpp"
 
+#include <memory>
 #include <vector>
 
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+
 template <unsigned n_words_>
 class BitGraph
 {
@@ -19,6 +28,13 @@ private:
   int _size = 0;
   Rows _adjacency;
 
+  const BitSet<n_words_> * _view = nullptr;
+  std::shared_ptr<const void> _view_owner;
+
+  auto row(int r) const -> const BitSet<n_words_> & {
+    return _view ? _view[r] : _adjacency[r];
+  }
+
 public:
   auto size() const -> int {
     return _size;
@@ -26,33 +42,76 @@ public:
 
   auto resize(int size) -> void {
     _size = size;
+    _view = nullptr;
+    _view_owner.reset();
     _adjacency.resize(size);
     for (auto & row : _adjacency)
       row.resize(size);
   }
 
+  // Use size rows starting at rows without copying them, owner keeps them
+  // alive
+  auto view(int size, const BitSet<n_words_> * rows, std::shared_ptr<const void> owner) -> void {
+    _size = size;
+    _adjacency.clear();
+    _view = rows;
+    _view_owner = std::move(owner);
+  }
+
+  auto rows() const -> const BitSet<n_words_> * {
+    return _view ? _view : _adjacency.data();
+  }
+
   auto add_edge(int a, int b) -> void {
     _adjacency[a].set(b);
     _adjacency[b].set(a);
   }
 
+  // Only touches row a, so different rows can be filled concurrently
+  auto add_arc(int a, int b) -> void {
+    _adjacency[a].set(b);
+  }
+
   auto adjacent(int a, int b) const -> bool {
-    return _adjacency[a].test(b);
+    return row(a).test(b);
   }
 
   auto intersect_with_row(int row, BitSet<n_words_> & p) const -> void {
-    p.intersect_with(_adjacency[row]);
+    p.intersect_with(this->row(row));
+  }
+
+  auto intersect_with_row_and_popcount(int row, BitSet<n_words_> & p) const -> unsigned {
+    return p.intersect_and_popcount(this->row(row));
+  }
+
+  auto row_intersects(int row, const BitSet<n_words_> & p) const -> bool {
+    return p.intersects(this->row(row));
   }
 
   auto intersect_with_row_complement(int row, BitSet<n_words_> & p) const -> void {
-    p.intersect_with_complement(_adjacency[row]);
+    p.intersect_with_complement(this->row(row));
   }
 
   template<class Archive>
-  void serialize(Archive & ar, const unsigned int version) {
+  void save(Archive & ar, const unsigned int version) const {
+    ar & _size;
+    if (_view) {
+      Rows rows(_view, _view + _size);
+      ar & rows;
+    } else {
+      ar & _adjacency;
+    }
+  }
+
+  template<class Archive>
+  void load(Archive & ar, const unsigned int version) {
     ar & _size;
     ar & _adjacency;
+    _view = nullptr;
+    _view_owner.reset();
   }
+
+  HPX_SERIALIZATION_SPLIT_MEMBER()
 };
 
 #endif
@@ -2,8 +2,8 @@
 #define _DIMACSPARSER_HPP_
 
 #include <string>
-#include <map>
-#include <set>
+
+#include "util/DimacsParser.hpp"
 
 class SomethingWentWrong : public std::exception
 {
@@ -20,7 +20,7 @@ public:
 };
 
 namespace dimacs {
-  using GraphFromFile = std::pair<unsigned, std::map<int, std::set<int> > >;
+  using GraphFromFile = YewPar::util::CSRGraph;
   auto read_dimacs(const std::string & filename) -> GraphFromFile;
 }
 
@@ -5,11 +5,13 @@
 #include <map>
 #include <chrono>
 #include <memory>
+#include <random>
 #include <typeinfo>
 
 #include <hpx/hpx_init.hpp>
 #include <hpx/include/iostreams.hpp>
 
+#include <boost/format.hpp>
 #include <boost/serialization/access.hpp>
 
 #include "DimacsParser.hpp"
@@ -26,69 +28,141 @@
 
 #include "util/func.hpp"
 #include "util/NodeGenerator.hpp"
+#include "util/GraphCache.hpp"
 
-// Number of Words to use in our bitset representation
-// Possible to specify at compile to to handler bigger graphs if required
+// Largest number of words to use in our bitset representation. Graphs are
+// searched with the smallest power of two number of words (or NWORDS) that
+// fits them, chosen at runtime. Possible to specify at compile time to
+// handle bigger graphs if required
 #ifndef NWORDS
 #define NWORDS 8
 #endif
 
-// Order a graphFromFile and return an ordered graph alongside a map to invert
-// the vertex numbering at the end.
+// Order a graphFromFile and return an ordered graph alongside the order, which
+// maps the new vertex numbering back to the file's.
 template<unsigned n_words_>
-auto orderGraphFromFile(const dimacs::GraphFromFile & g, std::map<int,int> & inv) -> BitGraph<n_words_> {
-  std::vector<int> order(g.first);
+auto orderGraphFromFile(const dimacs::GraphFromFile & g, std::vector<int> & order) -> BitGraph<n_words_> {
+  order.resize(g.size);
   std::iota(order.begin(), order.end(), 0);
 
   // Order by degree, tie break on number
-  std::vector<int> degrees;
-  std::transform(order.begin(), order.end(), std::back_inserter(degrees),
-                 [&] (int v) { return g.second.find(v)->second.size(); });
-
   std::sort(order.begin(), order.end(),
-            [&] (int a, int b) { return ! (degrees[a] < degrees[b] || (degrees[a] == degrees[b] && a > b)); });
+            [&] (int a, int b) { return ! (g.degree(a) < g.degree(b) || (g.degree(a) == g.degree(b) && a > b)); });
 
+  // Where each vertex ends up in the new ordering
+  std::vector<int> position(g.size);
+  for (unsigned i = 0 ; i < g.size ; ++i)
+    position[order[i]] = i;
 
-  // Construct a new graph with this new ordering
+  // Construct a new graph with this new ordering. Each row only depends on
+  // the neighbours of one vertex, so blocks of rows are filled in parallel.
   BitGraph<n_words_> graph;
-  graph.resize(g.first);
-
-  for (unsigned i = 0 ; i < g.first ; ++i)
-    for (unsigned j = 0 ; j < g.first ; ++j)
-      if (g.second.find(order[i])->second.count(order[j]))
-        graph.add_edge(i, j);
-
-  // Create inv map (maybe just return order?)
-  for (int i = 0; i < order.size(); i++) {
-    inv[i] = order[i];
+  graph.resize(g.size);
+
+  auto blocks = std::max(hpx::get_os_thread_count(), std::size_t{1});
+  auto blockSize = (g.size + blocks - 1) / blocks;
+  std::vector<hpx::future<void> > fills;
+  for (unsigned first = 0 ; first < g.size ; first += blockSize) {
+    auto last = std::min<unsigned>(first + blockSize, g.size);
+    fills.push_back(hpx::async([&, first, last]() {
+      for (auto i = first ; i < last ; ++i)
+        for (auto k = g.offsets[order[i]] ; k < g.offsets[order[i] + 1] ; ++k)
+          graph.add_arc(i, position[g.neighbours[k]]);
+    }));
   }
+  hpx::wait_all(fills);
 
   return graph;
 }
 
+// Try to move v, which would otherwise open a colour class above kmin, into
+// one of the classes up to kmin (Re-NUMBER, Tomita et al. 2010): either a class
+// with no neighbour of v, or one with a single neighbour w that can itself
+// move to a later class with no neighbour of w.
+template<unsigned n_words_>
+auto recolour(const BitGraph<n_words_> & graph,
+              std::vector<BitSet<n_words_> > & classes,
+              int kmin, int v) -> bool {
+  for (int k1 = 0 ; k1 < kmin ; ++k1) {
+    auto conflicts = classes[k1];
+    auto n = graph.intersect_with_row_and_popcount(v, conflicts);
+    if (n == 0) {
+      classes[k1].set(v);
+      return true;
+    }
+    if (n > 1)
+      continue;
+
+    int w = conflicts.first_set_bit();
+    for (int k2 = k1 + 1 ; k2 < kmin ; ++k2) {
+      if (! graph.row_intersects(w, classes[k2])) {
+        classes[k1].unset(w);
+        classes[k2].set(w);
+        classes[k1].set(v);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Greedily colour p one class at a time, building each class with bitset
+// operations (as in BBMC). Vertices given a colour of at most kmin can't lead
+// to a clique bigger than the incumbent so are not recorded, and any vertex
+// that would get a larger colour is first re-coloured into an earlier class
+// if possible. Returns the number of recorded vertices, which are in
+// non-decreasing colour order.
 template<unsigned n_words_>
 auto colour_class_order(const BitGraph<n_words_> & graph,
                         const BitSet<n_words_> & p,
                         std::array<unsigned, n_words_ * bits_per_word> & p_order,
-                        std::array<unsigned, n_words_ * bits_per_word> & p_bounds) -> void {
+                        std::array<unsigned, n_words_ * bits_per_word> & p_bounds,
+                        int kmin) -> unsigned {
+  // Classes up to kmin, only kept to recolour into. Nothing in here suspends
+  // the HPX thread so a buffer per OS thread can be reused between calls.
+  static thread_local std::vector<BitSet<n_words_> > classes;
+  kmin = std::max(kmin, 0);
+  if (classes.size() < static_cast<std::size_t>(kmin))
+    classes.resize(kmin);
+
   BitSet<n_words_> p_left = p; // not coloured yet
-  unsigned colour = 0;         // current colour
+  int colour = 0;              // current colour
   unsigned i = 0;              // position in p_bounds
 
   // while we've things left to colour
   while (! p_left.empty()) {
-    // next colour
-    ++colour;
-    // things that can still be given this colour
+    // things that can still be given the next colour
     BitSet<n_words_> q = p_left;
 
-    // while we can still give something this colour
-    while (! q.empty()) {
-      // first thing we can colour
-      int v = q.first_set_bit();
+    if (colour < kmin) {
+      auto & cls = classes[colour];
+      cls = BitSet<n_words_>();
+      for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
+        p_left.unset(v);
+        q.unset(v);
+        graph.intersect_with_row_complement(v, q);
+        cls.set(v);
+      }
+      ++colour;
+      continue;
+    }
+
+    // while we can still give something this colour (first thing we can
+    // colour, or -1 once q is empty)
+    bool opened = false;
+    for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
       p_left.unset(v);
       q.unset(v);
 
+      if (recolour(graph, classes, kmin, v))
+        continue;
+
+      // only count classes that end up with something in them
+      if (! opened) {
+        ++colour;
+        opened = true;
+      }
+
       // can't give anything adjacent to this the same colour
       graph.intersect_with_row_complement(v, q);
 
@@ -98,12 +172,14 @@ auto colour_class_order(const BitGraph<n_words_> & graph,
       ++i;
     }
   }
+
+  return i;
 }
 
 // Main Maxclique B&B Functions
-// Probably needs a copy constructor
+template <unsigned n_words_>
 struct MCSol {
-  std::vector<int> members;
+  BitSet<n_words_> members;
   int colours;
 
   template <class Archive>
@@ -113,12 +189,13 @@ struct MCSol {
   }
 };
 
+template <unsigned n_words_>
 struct MCNode {
   friend class boost::serialization::access;
 
-  MCSol sol;
+  MCSol<n_words_> sol;
   int size;
-  BitSet<NWORDS> remaining;
+  BitSet<n_words_> remaining;
 
   int getObj() const {
     return size;
@@ -133,31 +210,38 @@ struct MCNode {
 
 };
 
-struct GenNode : YewPar::NodeGenerator<MCNode, BitGraph<NWORDS> > {
-  std::array<unsigned, NWORDS * bits_per_word> p_order;
-  std::array<unsigned, NWORDS * bits_per_word> colourClass;
+template <unsigned n_words_>
+struct GenNode : YewPar::NodeGenerator<MCNode<n_words_>, BitGraph<n_words_> > {
+  std::array<unsigned, n_words_ * bits_per_word> p_order;
+  std::array<unsigned, n_words_ * bits_per_word> colourClass;
 
-  std::reference_wrapper<const BitGraph<NWORDS> > graph;
+  std::reference_wrapper<const BitGraph<n_words_> > graph;
 
-  MCSol childSol;
+  MCSol<n_words_> childSol;
   int childBnd;
-  BitSet<NWORDS> p;
+  BitSet<n_words_> p;
 
   int v;
 
-  GenNode(const BitGraph<NWORDS> & graph, const MCNode & n) : graph(std::cref(graph)) {
-    colour_class_order(graph, n.remaining, p_order, colourClass);
+  // Given the incumbent, children with a colour of at most kmin can't beat it
+  // (or reach the decision bound) so are never generated. Without it every
+  // vertex is a child, in a fixed order.
+  GenNode(const BitGraph<n_words_> & graph, const MCNode<n_words_> & n) :
+    GenNode(graph, n, YewPar::IncumbentBound<int>{0}) {}
+
+  GenNode(const BitGraph<n_words_> & graph, const MCNode<n_words_> & n,
+          YewPar::IncumbentBound<int> best) : graph(std::cref(graph)) {
+    this->numChildren = colour_class_order(graph, n.remaining, p_order, colourClass, best.bound - n.size);
     childSol = n.sol;
     childBnd = n.size + 1;
     p = n.remaining;
-    numChildren = p.popcount();
-    v = numChildren - 1;
+    v = this->numChildren - 1;
   }
 
   // Get the next value
-  MCNode next() override {
+  MCNode<n_words_> next() override {
     auto sol = childSol;
-    sol.members.push_back(p_order[v]);
+    sol.members.set(p_order[v]);
     sol.colours = colourClass[v] - 1;
 
     auto cands = p;
@@ -170,11 +254,11 @@ struct GenNode : YewPar::NodeGenerator<MCNode, BitGraph<NWORDS> > {
     return {sol, childBnd, cands};
   }
 
-  MCNode nth(unsigned n) {
+  MCNode<n_words_> nth(unsigned n) {
     auto pos = v - n;
 
     auto sol = childSol;
-    sol.members.push_back(p_order[pos]);
+    sol.members.set(p_order[pos]);
     sol.colours = colourClass[pos] - 1;
 
     auto cands = p;
@@ -189,31 +273,157 @@ struct GenNode : YewPar::NodeGenerator<MCNode, BitGraph<NWORDS> > {
   }
 };
 
-int upperBound(const BitGraph<NWORDS> & space, const MCNode & n) {
+template <unsigned n_words_>
+int upperBound(const BitGraph<n_words_> & space, const MCNode<n_words_> & n) {
   return n.size + n.sol.colours;
 }
 
-typedef func<decltype(&upperBound), &upperBound> upperBound_func;
+template <unsigned n_words_>
+using upperBound_func = func<decltype(&upperBound<n_words_>), &upperBound<n_words_> >;
 
+// Anytime search: report every improved clique as soon as it is found
+template <unsigned n_words_>
+void printIncumbent(const MCNode<n_words_> & n, int size, std::chrono::milliseconds t) {
+  hpx::cout << (boost::format("Incumbent %1% at %2% ms\n") % size % t.count()) << hpx::flush;
+}
 
-int hpx_main(boost::program_options::variables_map & opts) {
-  /*
-  if (!opts.count("input-file")) {
-    std::cerr << "You must provide an DIMACS input file with \n";
-    hpx::finalize();
-    return EXIT_FAILURE;
+template <unsigned n_words_>
+using printIncumbent_func = func<decltype(&printIncumbent<n_words_>), &printIncumbent<n_words_> >;
+
+// Warm start heuristic: a randomised greedy clique improved by local search.
+// Greedy repeatedly adds a vertex adjacent to the whole clique, preferring
+// high degree (vertices are numbered in degree order): the first such vertex
+// on the first run of each worker, one of the first four at random after.
+// Local search then looks for a (1,2)-swap, removing one member to add two
+// adjacent vertices that are adjacent to all the others, and extends the
+// clique again, until there is none. The node is only used as an incumbent.
+template <unsigned n_words_>
+MCNode<n_words_> warmStartHeuristic(const BitGraph<n_words_> & graph, const MCNode<n_words_> & root, std::uint64_t seed) {
+  std::mt19937_64 rand(seed);
+  auto randomised = (seed & 0xffffffff) != 0;
+
+  auto sol = root.sol;
+  auto size = root.size;
+  auto cands = root.remaining;
+
+  auto extend = [&]() {
+    for (int v = cands.first_set_bit() ; v != -1 ; v = cands.first_set_bit()) {
+      if (randomised) {
+        auto rest = cands;
+        for (auto skip = rand() % 4 ; skip > 0 ; --skip) {
+          rest.unset(v);
+          if (rest.empty())
+            break;
+          v = rest.first_set_bit();
+        }
+      }
+      sol.members.set(v);
+      ++size;
+      graph.intersect_with_row(v, cands);
+    }
+  };
+
+  extend();
+
+  auto improved = true;
+  while (improved) {
+    improved = false;
+    auto members = sol.members;
+    for (int v = members.first_set_bit() ; v != -1 && ! improved ; v = members.first_set_bit()) {
+      members.unset(v);
+
+      // Vertices adjacent to every member but v
+      auto c = root.remaining;
+      auto others = sol.members;
+      others.unset(v);
+      for (int u = others.first_set_bit() ; u != -1 ; u = others.first_set_bit()) {
+        others.unset(u);
+        graph.intersect_with_row(u, c);
+      }
+      c.unset(v);
+
+      for (int a = c.first_set_bit() ; a != -1 ; a = c.first_set_bit()) {
+        c.unset(a);
+        auto rest = c;
+        graph.intersect_with_row(a, rest);
+        if (! rest.empty()) {
+          sol.members.unset(v);
+          sol.members.set(a);
+          cands = rest;
+          extend();
+          improved = true;
+          break;
+        }
+      }
+    }
   }
-  */
 
-  //boost::program_options::notify(opts);
+  sol.colours = 0;
+  return {sol, size, cands};
+}
 
-  auto inputFile = opts["input-file"].as<std::string>();
+template <unsigned n_words_>
+using warmStart_func = func<decltype(&warmStartHeuristic<n_words_>), &warmStartHeuristic<n_words_> >;
+
+
+// Where the graph comes from: a parsed DIMACS file, or a graph cache holding
+// the ordered graph (see util/GraphCache.hpp). The cache has three sections:
+// the graph size, word count and row size; the order; and the BitGraph rows.
+struct GraphSource {
+  unsigned size = 0;
+  dimacs::GraphFromFile file;
+  std::shared_ptr<const YewPar::util::GraphCache> cache;
+  std::string cachePath;
+  std::uint64_t cacheKey = 0;
+};
+
+// Everything the layout of the cache depends on
+auto graphCacheKey(const std::string & inputFile) -> std::uint64_t {
+  return YewPar::util::cacheKey("maxclique", {YewPar::util::fileStamp(inputFile),
+                                              NWORDS, simd_words, bits_per_word});
+}
+
+template <unsigned n_words_>
+auto loadGraph(const GraphSource & src, std::vector<int> & order) -> BitGraph<n_words_> {
+  BitGraph<n_words_> graph;
+  if (src.cache) {
+    // The rows are used straight from the mapped cache
+    auto meta = src.cache->section<std::uint64_t>(0);
+    auto rows = src.cache->section<BitSet<n_words_> >(2);
+    if (meta.first[1] != n_words_ || meta.first[2] != sizeof(BitSet<n_words_>) || rows.second != src.size) {
+      throw SomethingWentWrong{ "graph cache " + src.cachePath + " is corrupt" };
+    }
+    order = src.cache->copySection<int>(1);
+    graph.view(src.size, rows.first, src.cache);
+    return graph;
+  }
+
+  graph = orderGraphFromFile<n_words_>(src.file, order);
+
+  if (! src.cachePath.empty()) {
+    std::uint64_t meta[] = { src.size, n_words_, sizeof(BitSet<n_words_>) };
+    YewPar::util::GraphCacheWriter cache;
+    cache.add(meta, 3);
+    cache.add(order);
+    cache.add(graph.rows(), src.size);
+    if (! cache.write(src.cachePath, src.cacheKey)) {
+      hpx::cout << "Could not write graph cache " << src.cachePath << hpx::endl;
+    }
+  }
+  return graph;
+}
 
-  auto gFile = dimacs::read_dimacs(inputFile);
+template <unsigned n_words_>
+int search(const GraphSource & src, boost::program_options::variables_map & opts) {
+  using GenNode = ::GenNode<n_words_>;
+  using MCNode = ::MCNode<n_words_>;
+  using upperBound_func = ::upperBound_func<n_words_>;
+  using printIncumbent_func = ::printIncumbent_func<n_words_>;
+  using warmStart_func = ::warmStart_func<n_words_>;
 
-  // Order the graph (keep a hold of the map)
-  std::map<int, int> invMap;
-  auto graph = orderGraphFromFile<NWORDS>(gFile, invMap);
+  // Order the graph (keep a hold of the order)
+  std::vector<int> order;
+  auto graph = loadGraph<n_words_>(src, order);
 
   auto spawnDepth = opts["spawn-depth"].as<std::uint64_t>();
   auto decisionBound = opts["decisionBound"].as<int>();
@@ -221,20 +431,47 @@ int hpx_main(boost::program_options::variables_map & opts) {
   auto start_time = std::chrono::steady_clock::now();
 
   // Initialise Root Node
-  MCSol mcsol;
-  mcsol.members.reserve(graph.size());
+  MCSol<n_words_> mcsol;
+  mcsol.members.resize(graph.size());
   mcsol.colours = 0;
 
-  BitSet<NWORDS> cands;
+  BitSet<n_words_> cands;
   cands.resize(graph.size());
   cands.set_all();
   MCNode root = { mcsol, 0, cands };
 
+  // Anytime limits apply to every skeleton
+  YewPar::Skeletons::API::Params<int> searchParameters;
+  searchParameters.timeLimit = opts["time-limit"].as<std::uint64_t>();
+  searchParameters.nodeLimit = opts["node-limit"].as<std::uint64_t>();
+  searchParameters.warmStartTime = opts["warm-start-time"].as<unsigned>();
+
+  searchParameters.progressInterval = opts["progress-interval"].as<unsigned>();
+  if (opts.count("progress-file")) {
+    searchParameters.progressFile = opts["progress-file"].as<std::string>();
+  }
+
+  if (opts.count("trace-file")) {
+    searchParameters.traceFile = opts["trace-file"].as<std::string>();
+  }
+
+  // Checkpointing is only supported by depthbounded
+  if (opts.count("checkpoint-file")) {
+    searchParameters.checkpointFile = opts["checkpoint-file"].as<std::string>();
+    searchParameters.checkpointInterval = opts["checkpoint-interval"].as<unsigned>();
+    searchParameters.restart = static_cast<bool>(opts.count("restart"));
+  }
+
+  // Decision searches prune bounds below decisionBound, which the node
+  // generator sees as an incumbent one smaller
+  if (decisionBound != 0) {
+    searchParameters.initialBound = decisionBound - 1;
+  }
+
   auto sol = root;
   auto skeletonType = opts["skeleton"].as<std::string>();
   if (skeletonType == "seq") {
     if (decisionBound != 0) {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.expectedObjective = decisionBound;
 
       sol = YewPar::Skeletons::Seq<GenNode,
@@ -246,12 +483,13 @@ int hpx_main(boost::program_options::variables_map & opts) {
     sol = YewPar::Skeletons::Seq<GenNode,
                                  YewPar::Skeletons::API::Optimisation,
                                  YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                 YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                 YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                  YewPar::Skeletons::API::PruneLevel>
-          ::search(graph, root);
+          ::search(graph, root, searchParameters);
     }
   } else if (skeletonType == "depthbounded") {
     if (decisionBound != 0) {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.expectedObjective = decisionBound;
       searchParameters.spawnDepth = spawnDepth;
       sol = YewPar::Skeletons::DepthBounded<GenNode,
@@ -260,13 +498,14 @@ int hpx_main(boost::program_options::variables_map & opts) {
                                            YewPar::Skeletons::API::PruneLevel>
             ::search(graph, root, searchParameters);
     } else {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.spawnDepth = spawnDepth;
       auto poolType = opts["poolType"].as<std::string>();
       if (poolType == "deque") {
         sol = YewPar::Skeletons::DepthBounded<GenNode,
                                              YewPar::Skeletons::API::Optimisation,
                                              YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                             YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                             YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                              YewPar::Skeletons::API::PruneLevel,
                                              YewPar::Skeletons::API::DepthBoundedPoolPolicy<
                                                Workstealing::Policies::Workpool> >
@@ -275,6 +514,8 @@ int hpx_main(boost::program_options::variables_map & opts) {
         sol = YewPar::Skeletons::DepthBounded<GenNode,
                                              YewPar::Skeletons::API::Optimisation,
                                              YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                             YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                             YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                              YewPar::Skeletons::API::PruneLevel,
                                              YewPar::Skeletons::API::DepthBoundedPoolPolicy<
                                                Workstealing::Policies::DepthPoolPolicy> >
@@ -283,7 +524,6 @@ int hpx_main(boost::program_options::variables_map & opts) {
     }
   } else if (skeletonType == "stacksteal") {
     if (decisionBound != 0) {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.expectedObjective = decisionBound;
       searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
       sol = YewPar::Skeletons::StackStealing<GenNode,
@@ -292,21 +532,23 @@ int hpx_main(boost::program_options::variables_map & opts) {
                                              YewPar::Skeletons::API::PruneLevel>
           ::search(graph, root, searchParameters);
     } else {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
       sol = YewPar::Skeletons::StackStealing<GenNode,
                                              YewPar::Skeletons::API::Optimisation,
                                              YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                             YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                             YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                              YewPar::Skeletons::API::PruneLevel>
           ::search(graph, root, searchParameters);
     }
   } else if (skeletonType == "ordered") {
-    YewPar::Skeletons::API::Params<int> searchParameters;
     searchParameters.spawnDepth = spawnDepth;
     if (opts.count("discrepancyOrder")) {
       sol = YewPar::Skeletons::Ordered<GenNode,
                                        YewPar::Skeletons::API::Optimisation,
                                        YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                       YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                       YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                        YewPar::Skeletons::API::DiscrepancySearch,
                                        YewPar::Skeletons::API::PruneLevel>
           ::search(graph, root, searchParameters);
@@ -314,12 +556,13 @@ int hpx_main(boost::program_options::variables_map & opts) {
     sol = YewPar::Skeletons::Ordered<GenNode,
                                          YewPar::Skeletons::API::Optimisation,
                                          YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                         YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                         YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                          YewPar::Skeletons::API::PruneLevel>
           ::search(graph, root, searchParameters);
     }
   } else if (skeletonType == "budget") {
     if (decisionBound != 0) {
-    YewPar::Skeletons::API::Params<int> searchParameters;
     searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
     searchParameters.expectedObjective = decisionBound;
     sol = YewPar::Skeletons::Budget<GenNode,
@@ -328,11 +571,12 @@ int hpx_main(boost::program_options::variables_map & opts) {
                                     YewPar::Skeletons::API::PruneLevel>
         ::search(graph, root, searchParameters);
     } else {
-      YewPar::Skeletons::API::Params<int> searchParameters;
       searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
       sol = YewPar::Skeletons::Budget<GenNode,
                                       YewPar::Skeletons::API::Optimisation,
                                       YewPar::Skeletons::API::BoundFunction<upperBound_func>,
+                                      YewPar::Skeletons::API::IncumbentCallback<printIncumbent_func>,
+                                      YewPar::Skeletons::API::WarmStart<warmStart_func>,
                                       YewPar::Skeletons::API::PruneLevel>
           ::search(graph, root, searchParameters);
     }
@@ -351,6 +595,58 @@ int hpx_main(boost::program_options::variables_map & opts) {
   return hpx::finalize();
 }
 
+// Search with the smallest size class that fits the graph, doubling up to
+// NWORDS
+template <unsigned n_words_>
+int searchSizeClass(const GraphSource & src, boost::program_options::variables_map & opts) {
+  if (src.size <= n_words_ * bits_per_word) {
+    return search<n_words_>(src, opts);
+  }
+
+  if constexpr (n_words_ < NWORDS) {
+    return searchSizeClass<std::min(n_words_ * 2, static_cast<unsigned>(NWORDS))>(src, opts);
+  } else {
+    hpx::cout << "Binary Cannot Handle Graph of this size. Recompile with a bigger NWORDS" << hpx::endl;
+    hpx::finalize();
+    return EXIT_FAILURE;
+  }
+}
+
+int hpx_main(boost::program_options::variables_map & opts) {
+  /*
+  if (!opts.count("input-file")) {
+    std::cerr << "You must provide an DIMACS input file with \n";
+    hpx::finalize();
+    return EXIT_FAILURE;
+  }
+  */
+
+  //boost::program_options::notify(opts);
+
+  auto inputFile = opts["input-file"].as<std::string>();
+
+  // With a graph cache the ordered graph is mapped from the cache file, the
+  // DIMACS file is only parsed and ordered when the cache is missing or stale
+  GraphSource src;
+  if (opts.count("graph-cache")) {
+    src.cachePath = opts["graph-cache"].as<std::string>();
+    src.cacheKey = graphCacheKey(inputFile);
+    src.cache = YewPar::util::GraphCache::open(src.cachePath, src.cacheKey);
+    if (src.cache && (src.cache->sections() != 3 || src.cache->section<std::uint64_t>(0).second != 3)) {
+      src.cache.reset();
+    }
+  }
+
+  if (src.cache) {
+    src.size = src.cache->section<std::uint64_t>(0).first[0];
+  } else {
+    src.file = dimacs::read_dimacs(inputFile);
+    src.size = src.file.size;
+  }
+
+  return searchSizeClass<1>(src, opts);
+}
+
 int main (int argc, char* argv[]) {
   boost::program_options::options_description
     desc_commandline("Usage: " HPX_APPLICATION_STRING " [options]");
@@ -372,6 +668,10 @@ int main (int argc, char* argv[]) {
       boost::program_options::value<std::string>()->required(),
       "DIMACS formatted input graph"
       )
+    ( "graph-cache",
+      boost::program_options::value<std::string>(),
+      "Keep the ordered graph in this file and map it on later runs instead of parsing the input again"
+      )
     ("discrepancyOrder", "Use discrepancy order for the ordered skeleton")
     ("chunked", "Use chunking with stack stealing")
     ("poolType",
@@ -380,6 +680,39 @@ int main (int argc, char* argv[]) {
     ( "decisionBound",
     boost::program_options::value<int>()->default_value(0),
     "For Decision Skeletons. Size of the clique to search for"
+    )
+    ( "time-limit",
+      boost::program_options::value<std::uint64_t>()->default_value(0),
+      "Stop after this many milliseconds and report the best clique found (0 = no limit)"
+    )
+    ( "node-limit",
+      boost::program_options::value<std::uint64_t>()->default_value(0),
+      "Stop after processing this many nodes and report the best clique found (0 = no limit)"
+    )
+    ( "warm-start-time",
+      boost::program_options::value<unsigned>()->default_value(0),
+      "Time (ms) to run the greedy/local search heuristic on every worker for an initial incumbent"
+    )
+    ( "checkpoint-file",
+      boost::program_options::value<std::string>(),
+      "Periodically checkpoint the search to this file (depthbounded only)"
+    )
+    ( "checkpoint-interval",
+      boost::program_options::value<unsigned>()->default_value(300),
+      "Seconds between checkpoints"
+    )
+    ("restart", "Resume the search from the checkpoint file")
+    ( "progress-interval",
+      boost::program_options::value<unsigned>()->default_value(0),
+      "Report search statistics as JSON lines every this many seconds (0 = off, parallel skeletons only)"
+    )
+    ( "progress-file",
+      boost::program_options::value<std::string>(),
+      "Write progress reports to this file instead of stdout"
+    )
+    ( "trace-file",
+      boost::program_options::value<std::string>(),
+      "Write a Chrome trace of scheduler events here (requires YEWPAR_TRACING)"
     );
 
   YewPar::registerPerformanceCounters();
@@ -44,6 +44,14 @@ public:
     p.intersect_with(_adjacency[row]);
   }
 
+  auto intersect_with_row_and_popcount(int row, BitSet<n_words_> & p) const -> unsigned {
+    return p.intersect_and_popcount(_adjacency[row]);
+  }
+
+  auto row_intersects(int row, const BitSet<n_words_> & p) const -> bool {
+    return p.intersects(_adjacency[row]);
+  }
+
   auto intersect_with_row_complement(int row, BitSet<n_words_> & p) const -> void {
     p.intersect_with_complement(_adjacency[row]);
   }
@@ -4,20 +4,96 @@
 /**
  * Ciaran McCressh's Bitset implementation for MaxClique, containing a fixed
  * number of words which is selected at compile time.
+ *
+ * The set also tracks a range of words [_lo, _hi) outside of which every
+ * word is zero, and bulk operations only touch this range. It matters deep in
+ * the search where candidate sets are small but NWORDS is sized for the whole
+ * graph, and is only kept for sets of a few vectors or more. The range is
+ * narrowed by intersect_with (taking a neighbourhood), but not by unset or
+ * intersect_with_complement: re-trimming there puts unpredictable branches
+ * on the colouring loop and costs more than it saves.
+ *
+ * The bulk operations are written with AVX-512 or AVX2 intrinsics when the
+ * compiler targets them (we build with -march=native) and fall back to a word
+ * at a time loop otherwise. The words are padded to a whole number of
+ * vectors so the range can be widened to vector boundaries: the extra words
+ * are zero, so including them never changes a result.
  */
 
+#include <algorithm>
 #include <array>
 
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 using BitWord = unsigned long long;
 static const constexpr int bits_per_word = sizeof(BitWord) * 8;
 
+#if defined(__AVX512F__)
+static const constexpr unsigned simd_words = 8;
+#elif defined(__AVX2__)
+static const constexpr unsigned simd_words = 4;
+#else
+static const constexpr unsigned simd_words = 1;
+#endif
+
 template <unsigned words_>
 class BitSet {
 private:
-  using Bits = std::array<BitWord, words_>;
+  // words_ rounded up to a whole number of vectors
+  static const constexpr unsigned padded_words_ = (words_ + simd_words - 1) / simd_words * simd_words;
+
+  using Bits = std::array<BitWord, padded_words_>;
+
+  // Only worth tracking the range once a set spans a few vectors, below that
+  // the bookkeeping costs more than the words it skips
+  static const constexpr bool track_range_ = padded_words_ >= 4 * simd_words;
 
   int _size  = 0;
-  Bits _bits = {{ }};
+  unsigned _lo = 0;
+  unsigned _hi = 0;
+  alignas(simd_words * sizeof(BitWord)) Bits _bits = {{ }};
+
+#if defined(__AVX2__) && !defined(__AVX512VPOPCNTDQ__)
+  // Per 64-bit lane popcount using a nibble lookup table (Mula et al.)
+  static auto popcount_lanes(__m256i v) -> __m256i {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    auto lo = _mm256_and_si256(v, low_mask);
+    auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+  }
+
+  static auto sum_lanes(__m256i v) -> unsigned {
+    auto s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+  }
+#endif
+
+  // Shrink [_lo, _hi) until both ends are non-zero words
+  auto trim() -> void {
+    while (_lo < _hi && 0 == _bits[_lo])
+      ++_lo;
+    while (_hi > _lo && 0 == _bits[_hi - 1])
+      --_hi;
+  }
+
+  // First word of the vector holding word w
+  static auto vector_start(unsigned w) -> unsigned {
+    return w - w % simd_words;
+  }
+
+  // Words the bulk operations run over
+  auto first_word() const -> unsigned {
+    return track_range_ ? vector_start(_lo) : 0;
+  }
+
+  auto last_word() const -> unsigned {
+    return track_range_ ? _hi : padded_words_;
+  }
 
 public:
   auto resize(int size) -> void {
@@ -25,11 +101,22 @@ public:
   }
 
   auto set(int a) -> void {
-    _bits[a / bits_per_word] |= (BitWord{ 1 } << (a % bits_per_word));
+    unsigned w = a / bits_per_word;
+    _bits[w] |= (BitWord{ 1 } << (a % bits_per_word));
+    if constexpr (track_range_) {
+      if (_lo >= _hi) {
+        _lo = w;
+        _hi = w + 1;
+      } else {
+        _lo = std::min(_lo, w);
+        _hi = std::max(_hi, w + 1);
+      }
+    }
   }
 
   auto unset(int a) -> void {
-    _bits[a / bits_per_word] &= ~(BitWord{ 1 } << (a % bits_per_word));
+    unsigned w = a / bits_per_word;
+    _bits[w] &= ~(BitWord{ 1 } << (a % bits_per_word));
   }
 
   auto set_all() -> void {
@@ -43,41 +130,183 @@ public:
   }
 
   auto popcount() const -> unsigned {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    auto acc = _mm512_setzero_si512();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words)
+      acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_load_si512(&_bits[i])));
+    return _mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__) && !defined(__AVX512F__)
+    auto acc = _mm256_setzero_si256();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words)
+      acc = _mm256_add_epi64(acc, popcount_lanes(_mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i]))));
+    return sum_lanes(acc);
+#else
     unsigned result = 0;
-    for (auto & p : _bits)
-      result += __builtin_popcountll(p);
+    for (auto i = first_word() ; i < last_word() ; ++i)
+      result += __builtin_popcountll(_bits[i]);
     return result;
+#endif
   }
 
   auto empty() const -> bool {
-    for (auto & p : _bits)
-      if (0 != p)
+#if defined(__AVX512F__)
+    auto acc = _mm512_setzero_si512();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words)
+      acc = _mm512_or_si512(acc, _mm512_load_si512(&_bits[i]));
+    return 0 == _mm512_test_epi64_mask(acc, acc);
+#elif defined(__AVX2__)
+    auto acc = _mm256_setzero_si256();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words)
+      acc = _mm256_or_si256(acc, _mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i])));
+    return _mm256_testz_si256(acc, acc);
+#else
+    for (auto i = first_word() ; i < last_word() ; ++i)
+      if (0 != _bits[i])
         return false;
     return true;
+#endif
   }
 
   auto intersect_with(const BitSet<words_> & other) -> void {
-    for (typename Bits::size_type i = 0 ; i < words_ ; ++i)
+    // Words outside other's range become zero, so the result lies in the
+    // overlap of the ranges, but every word of ours outside it must be cleared
+#if defined(__AVX512F__)
+    for (auto i = first_word() ; i < last_word() ; i += simd_words)
+      _mm512_store_si512(&_bits[i], _mm512_and_si512(_mm512_load_si512(&_bits[i]),
+                                                     _mm512_load_si512(&other._bits[i])));
+#elif defined(__AVX2__)
+    for (auto i = first_word() ; i < last_word() ; i += simd_words) {
+      auto a = _mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i]));
+      auto b = _mm256_load_si256(reinterpret_cast<const __m256i *>(&other._bits[i]));
+      _mm256_store_si256(reinterpret_cast<__m256i *>(&_bits[i]), _mm256_and_si256(a, b));
+    }
+#else
+    for (auto i = first_word() ; i < last_word() ; ++i)
       _bits[i] = _bits[i] & other._bits[i];
+#endif
+    if constexpr (track_range_) {
+      _lo = std::max(_lo, other._lo);
+      _hi = std::min(_hi, other._hi);
+      trim();
+    }
   }
 
   auto intersect_with_complement(const BitSet<words_> & other) -> void {
-    for (typename Bits::size_type i = 0 ; i < words_ ; ++i)
+    // Only words where other can be non-zero change
+    auto begin = track_range_ ? vector_start(std::max(_lo, other._lo)) : 0;
+    auto end = track_range_ ? std::min(_hi, other._hi) : padded_words_;
+#if defined(__AVX512F__)
+    for (auto i = begin ; i < end ; i += simd_words)
+      _mm512_store_si512(&_bits[i], _mm512_andnot_si512(_mm512_load_si512(&other._bits[i]),
+                                                        _mm512_load_si512(&_bits[i])));
+#elif defined(__AVX2__)
+    for (auto i = begin ; i < end ; i += simd_words) {
+      auto a = _mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i]));
+      auto b = _mm256_load_si256(reinterpret_cast<const __m256i *>(&other._bits[i]));
+      _mm256_store_si256(reinterpret_cast<__m256i *>(&_bits[i]), _mm256_andnot_si256(b, a));
+    }
+#else
+    for (auto i = begin ; i < end ; ++i)
       _bits[i] = _bits[i] & ~other._bits[i];
+#endif
+  }
+
+  // intersect_with followed by popcount, in a single pass
+  auto intersect_and_popcount(const BitSet<words_> & other) -> unsigned {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    auto acc = _mm512_setzero_si512();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words) {
+      auto v = _mm512_and_si512(_mm512_load_si512(&_bits[i]), _mm512_load_si512(&other._bits[i]));
+      _mm512_store_si512(&_bits[i], v);
+      acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+    unsigned result = _mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__) && !defined(__AVX512F__)
+    auto acc = _mm256_setzero_si256();
+    for (auto i = first_word() ; i < last_word() ; i += simd_words) {
+      auto v = _mm256_and_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i])),
+                                _mm256_load_si256(reinterpret_cast<const __m256i *>(&other._bits[i])));
+      _mm256_store_si256(reinterpret_cast<__m256i *>(&_bits[i]), v);
+      acc = _mm256_add_epi64(acc, popcount_lanes(v));
+    }
+    unsigned result = sum_lanes(acc);
+#else
+    unsigned result = 0;
+    for (auto i = first_word() ; i < last_word() ; ++i) {
+      _bits[i] = _bits[i] & other._bits[i];
+      result += __builtin_popcountll(_bits[i]);
+    }
+#endif
+    if constexpr (track_range_) {
+      _lo = std::max(_lo, other._lo);
+      _hi = std::min(_hi, other._hi);
+      trim();
+    }
+    return result;
+  }
+
+  // Whether the intersection with other is non-empty, without computing it
+  auto intersects(const BitSet<words_> & other) const -> bool {
+    auto begin = track_range_ ? vector_start(std::max(_lo, other._lo)) : 0;
+    auto end = track_range_ ? std::min(_hi, other._hi) : padded_words_;
+#if defined(__AVX512F__)
+    auto acc = _mm512_setzero_si512();
+    for (auto i = begin ; i < end ; i += simd_words)
+      acc = _mm512_or_si512(acc, _mm512_and_si512(_mm512_load_si512(&_bits[i]),
+                                                   _mm512_load_si512(&other._bits[i])));
+    return 0 != _mm512_test_epi64_mask(acc, acc);
+#elif defined(__AVX2__)
+    auto acc = _mm256_setzero_si256();
+    for (auto i = begin ; i < end ; i += simd_words) {
+      auto a = _mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i]));
+      auto b = _mm256_load_si256(reinterpret_cast<const __m256i *>(&other._bits[i]));
+      acc = _mm256_or_si256(acc, _mm256_and_si256(a, b));
+    }
+    return ! _mm256_testz_si256(acc, acc);
+#else
+    for (auto i = begin ; i < end ; ++i)
+      if (0 != (_bits[i] & other._bits[i]))
+        return true;
+    return false;
+#endif
   }
 
   auto first_set_bit() const -> int {
-    for (typename Bits::size_type i = 0 ; i < _bits.size() ; ++i) {
+#if defined(__AVX512F__)
+    // Find the first non-zero word a vector at a time
+    for (auto i = first_word() ; i < last_word() ; i += simd_words) {
+      auto v = _mm512_load_si512(&_bits[i]);
+      unsigned nonzero = _mm512_test_epi64_mask(v, v);
+      if (0 != nonzero) {
+        auto w = i + __builtin_ctz(nonzero);
+        return w * bits_per_word + __builtin_ctzll(_bits[w]);
+      }
+    }
+#elif defined(__AVX2__)
+    for (auto i = first_word() ; i < last_word() ; i += simd_words) {
+      auto v = _mm256_load_si256(reinterpret_cast<const __m256i *>(&_bits[i]));
+      auto zero = _mm256_cmpeq_epi64(v, _mm256_setzero_si256());
+      unsigned nonzero = ~_mm256_movemask_pd(_mm256_castsi256_pd(zero)) & 0xf;
+      if (0 != nonzero) {
+        auto w = i + __builtin_ctz(nonzero);
+        return w * bits_per_word + __builtin_ctzll(_bits[w]);
+      }
+    }
+#else
+    for (auto i = first_word() ; i < last_word() ; ++i) {
       int b = __builtin_ffsll(_bits[i]);
       if (0 != b)
         return i * bits_per_word + b - 1;
     }
+#endif
     return -1;
   }
 
   template<class Archive>
   void serialize(Archive & ar, const unsigned version) {
     ar & _size;
+    ar & _lo;
+    ar & _hi;
     ar & _bits;
   }
 };
@@ -1,8 +1,11 @@
 #include "VFParser.hpp"
 
-#include <fstream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
+#include "util/MappedFile.hpp"
+
 GraphFileError::GraphFileError(const std::string & filename, const std::string & message) throw () :
   _what("Error reading graph file '" + filename + "': " + message) {}
 
@@ -10,24 +13,40 @@ auto GraphFileError::what() const throw () -> const char * {
   return _what.c_str();
 }
 
-auto read_word(std::ifstream & infile) -> unsigned
-{
-  unsigned char a, b;
-  a = static_cast<unsigned char>(infile.get());
-  b = static_cast<unsigned char>(infile.get());
-  return unsigned(a) | (unsigned(b) << 8);
-}
+// Little endian 16 bit words read straight from the mapped file. Reading
+// past the end gives 0xffff and clears ok, like a failed istream::get.
+struct WordReader {
+  const char * p;
+  const char * end;
+  bool ok = true;
+
+  auto read_word() -> unsigned {
+    if (end - p < 2) {
+      p = end;
+      ok = false;
+      return 0xffff;
+    }
+    auto a = static_cast<unsigned char>(p[0]);
+    auto b = static_cast<unsigned char>(p[1]);
+    p += 2;
+    return unsigned(a) | (unsigned(b) << 8);
+  }
+};
 
 auto read_vf(const std::string & filename, bool unlabelled, bool no_edge_labels, bool undirected) -> VFGraph
 {
   VFGraph result;
 
-  std::ifstream infile{ filename };
-  if (! infile)
-    throw GraphFileError{ filename, "unable to open file" };
+  std::unique_ptr<YewPar::util::MappedFile> file;
+  try {
+    file = std::make_unique<YewPar::util::MappedFile>(filename);
+  } catch (const std::runtime_error & e) {
+    throw GraphFileError{ filename, e.what() };
+  }
+  WordReader infile{ file->begin(), file->end() };
 
-  result.size = read_word(infile);
-  if (! infile)
+  result.size = infile.read_word();
+  if (! infile.ok)
     throw GraphFileError{ filename, "error reading size" };
 
   // to be like the CP 2011 labelling scheme...
@@ -50,33 +69,33 @@ auto read_vf(const std::string & filename, bool unlabelled, bool no_edge_labels,
     e.resize(result.size);
 
   for (unsigned r = 0 ; r < result.size ; ++r) {
-    unsigned l = read_word(infile) >> (16 - k1);
+    unsigned l = infile.read_word() >> (16 - k1);
     if (unlabelled)
       l = 0;
     result.vertex_labels.at(r) = l;
     result.vertices_by_label.at(l).push_back(r);
   }
 
-  if (! infile)
+  if (! infile.ok)
     throw GraphFileError{ filename, "error reading attributes" };
 
   for (unsigned r = 0 ; r < result.size ; ++r) {
-    int c_end = read_word(infile);
-    if (! infile)
+    int c_end = infile.read_word();
+    if (! infile.ok)
       throw GraphFileError{ filename, "error reading edges count" };
 
     for (int c = 0 ; c < c_end ; ++c) {
-      unsigned e = read_word(infile);
+      unsigned e = infile.read_word();
 
       if (e >= result.size)
         throw GraphFileError{ filename, "edge index " + std::to_string(e) + " out of bounds" };
 
       if (unlabelled) {
         result.edges[r][e] = 1;
-        read_word(infile);
+        infile.read_word();
       }
       else {
-        unsigned l = (read_word(infile) >> (16 - k1)) + 1;
+        unsigned l = (infile.read_word() >> (16 - k1)) + 1;
         //                     if (result.edges[r][e] != 0 && result.edges[r][e] != l)
         //                         throw GraphFileError{ filename, "contradicting labels on " + std::to_string(r) + " and " + std::to_string(e) };
 
@@ -93,8 +112,7 @@ auto read_vf(const std::string & filename, bool unlabelled, bool no_edge_labels,
     }
   }
 
-  infile.peek();
-  if (! infile.eof())
+  if (infile.p != infile.end)
     throw GraphFileError{ filename, "EOF not reached" };
 
   return result;
@@ -102,22 +102,22 @@ template<unsigned n_words_>
 auto colour_class_order(const BitGraph<n_words_> & graph,
                         const BitSet<n_words_> & p,
                         std::array<unsigned, n_words_ * bits_per_word> & p_order,
-                        std::array<unsigned, n_words_ * bits_per_word> & p_bounds) -> void {
+                        std::array<unsigned, n_words_ * bits_per_word> & p_bounds) -> unsigned {
   BitSet<n_words_> p_left = p; // not coloured yet
   unsigned colour = 0;         // current colour
   unsigned i = 0;              // position in p_bounds
+  const unsigned n = p.popcount(); // number of things to colour
 
   // while we've things left to colour
-  while (! p_left.empty()) {
+  while (i < n) {
     // next colour
     ++colour;
     // things that can still be given this colour
     BitSet<n_words_> q = p_left;
 
-    // while we can still give something this colour
-    while (! q.empty()) {
-      // first thing we can colour
-      int v = q.first_set_bit();
+    // while we can still give something this colour (first thing we can
+    // colour, or -1 once q is empty)
+    for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
       p_left.unset(v);
       q.unset(v);
 
@@ -130,6 +130,8 @@ auto colour_class_order(const BitGraph<n_words_> & graph,
       ++i;
     }
   }
+
+  return n;
 }
 
 // Main Maxclique B&B Functions
@@ -178,11 +180,10 @@ struct GenNode : YewPar::NodeGenerator<MCNode, BitGraph<NWORDS> > {
   int v;
 
   GenNode(const BitGraph<NWORDS> & graph, const MCNode & n) : graph(std::cref(graph)) {
-    colour_class_order(graph, n.remaining, p_order, colourClass);
+    numChildren = colour_class_order(graph, n.remaining, p_order, colourClass);
     childSol = n.sol;
     childBnd = n.size + 1;
     p = n.remaining;
-    numChildren = p.popcount();
     v = numChildren - 1;
   }
 
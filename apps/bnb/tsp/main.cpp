@@ -1,11 +1,19 @@
 #include <iostream>
+#include <algorithm>
+#include <numeric>
 #include <set>
 #include <chrono>
 #include <bitset>
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
 
 #include <hpx/hpx_init.hpp>
 #include <hpx/include/iostreams.hpp>
 #include <hpx/runtime/serialization/bitset.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
 
 #include "parser.hpp"
 #include "YewPar.hpp"
@@ -16,51 +24,70 @@
 #include "skeletons/Budget.hpp"
 #include "skeletons/StackStealing.hpp"
 
-#define MAX_CITIES  64
-
-struct TSPSol {
-  std::vector<unsigned> cities;
-  unsigned tourLength;
-
-  template <class Archive>
-  void serialize(Archive & ar, const unsigned int version) {
-    ar & cities;
-    ar & tourLength;
-  }
-};
+// Largest number of 64 bit words in the sets of unvisited cities. Instances
+// are searched with the smallest power of two number of words (or NWORDS)
+// that fits their cities, chosen at runtime. Possible to specify at compile
+// time to handle bigger instances if required
+#ifndef NWORDS
+#define NWORDS 4
+#endif
 
 struct TSPSpace {
-  DistanceMatrix<MAX_CITIES> distances;
+  DistanceMatrix distances;
   unsigned numCities;
+  // Bound children with Held-Karp rather than a minimum spanning tree
+  bool heldKarp;
+  unsigned heldKarpIterations;
 
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
     ar & distances;
     ar & numCities;
+    ar & heldKarp;
+    ar & heldKarpIterations;
   }
 };
 
+// Nodes are a fixed size: the tour so far is an array rather than a vector,
+// so generating children doesn't allocate
+template <unsigned n_words_>
 struct TSPNode {
-  TSPSol sol;
-  std::bitset<MAX_CITIES> unvisited;
+  // Cities in the order visited, back to the first once the tour is complete
+  std::array<std::uint16_t, n_words_ * 64> cities;
+  unsigned numVisited;
+  unsigned tourLength;
+  std::bitset<n_words_ * 64> unvisited;
+  // Bound on the length of any tour completing this one, computed by the
+  // generator
+  unsigned bound;
 
   unsigned getObj() const {
     if (unvisited.none()) {
-      return sol.tourLength;
+      return tourLength;
     } else {
       return INT_MAX;
     }
   }
 
+  unsigned first() const {
+    return cities[0];
+  }
+
+  unsigned last() const {
+    return cities[numVisited - 1];
+  }
+
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
-    ar & sol;
+    ar & cities;
+    ar & numVisited;
+    ar & tourLength;
     ar & unvisited;
+    ar & bound;
   }
 
 };
 
-
 template <std::size_t words_>
 static unsigned next_set(const std::bitset<words_> & bs, unsigned max, unsigned last_set) {
   for (auto i = last_set + 1; i <= max; ++i) {
@@ -68,101 +95,362 @@ static unsigned next_set(const std::bitset<words_> & bs, unsigned max, unsigned
       return i;
     }
   }
+  // None left (only reached after the last child)
+  return max + 1;
+}
+
+// Gather the cities in a set into cs, returning how many there are
+template <unsigned n_words_>
+unsigned citiesOf(const TSPSpace & space,
+                  const std::bitset<n_words_ * 64> & set,
+                  std::array<unsigned, n_words_ * 64> & cs) {
+  auto k = 0u;
+  for (auto i = 1u; i <= space.numCities; ++i) {
+    if (set.test(i)) {
+      cs[k++] = i;
+    }
+  }
+  return k;
+}
+
+// Weight of a minimum spanning tree over a set of cities (Prim's algorithm)
+template <unsigned n_words_>
+unsigned mst(const TSPSpace & space, const std::bitset<n_words_ * 64> & set) {
+  std::array<unsigned, n_words_ * 64> cs;
+  auto k = citiesOf<n_words_>(space, set, cs);
+  if (k == 0) {
+    return 0;
+  }
+
+  // Cities not yet in the tree are kept in cs[0..rem), with their distance
+  // to the tree in weights
+  std::array<unsigned, n_words_ * 64> weights;
+  auto rem = k - 1;
+  for (auto i = 0u; i < rem; ++i) {
+    weights[i] = space.distances[cs[k - 1]][cs[i]];
+  }
+
+  auto w = 0u;
+  while (rem > 0) {
+    auto min = 0u;
+    for (auto i = 1u; i < rem; ++i) {
+      if (weights[i] < weights[min]) {
+        min = i;
+      }
+    }
+
+    auto minCity = cs[min];
+    w += weights[min];
+    --rem;
+    cs[min] = cs[rem];
+    weights[min] = weights[rem];
+
+    for (auto i = 0u; i < rem; ++i) {
+      auto dist = space.distances[minCity][cs[i]];
+      if (dist < weights[i]) {
+        weights[i] = dist;
+      }
+    }
+  }
+
+  return w;
 }
 
-struct NodeGen : YewPar::NodeGenerator<TSPNode, TSPSpace> {
+// Held-Karp bound on the rest of a tour: a path from `from` through all of
+// `set` and back to `start`. Dropping its two end edges leaves a spanning
+// tree of `set`, so for any penalties pi on the cities a 1-tree (a spanning
+// tree of `set` plus the cheapest edge to each end) under the costs
+// d(u, v) + pi(u) + pi(v), minus twice the penalties, bounds it. Subgradient
+// optimisation moves pi towards giving every city degree two, where the
+// 1-tree is a path. We stop early once the bound reaches `target`, as the
+// node is pruned anyway.
+template <unsigned n_words_>
+unsigned heldKarp(const TSPSpace & space, unsigned from, unsigned start,
+                  const std::bitset<n_words_ * 64> & set, unsigned target) {
+  const auto & d = space.distances;
+  std::array<unsigned, n_words_ * 64> cs;
+  auto k = citiesOf<n_words_>(space, set, cs);
+  if (k == 0) {
+    return d[from][start];
+  } else if (k == 1) {
+    return d[from][cs[0]] + d[cs[0]][start];
+  }
+
+  std::array<double, n_words_ * 64> pi {};
+  std::array<double, n_words_ * 64> key;
+  std::array<unsigned, n_words_ * 64> parent;
+  std::array<int, n_words_ * 64> degree;
+  std::array<bool, n_words_ * 64> inTree;
+
+  auto best = 0.0;
+  auto lambda = 2.0;
+  for (auto iter = 0u; iter < space.heldKarpIterations; ++iter) {
+    // Prim's algorithm under the penalised costs, tracking degrees
+    std::fill(degree.begin(), degree.begin() + k, 0);
+    std::fill(inTree.begin(), inTree.begin() + k, false);
+    std::fill(key.begin(), key.begin() + k, std::numeric_limits<double>::max());
+    key[0] = 0;
+    auto tree = 0.0;
+    for (auto n = 0u; n < k; ++n) {
+      auto j = k;
+      for (auto l = 0u; l < k; ++l) {
+        if (!inTree[l] && (j == k || key[l] < key[j])) {
+          j = l;
+        }
+      }
+      inTree[j] = true;
+      tree += key[j];
+      if (n > 0) {
+        ++degree[j];
+        ++degree[parent[j]];
+      }
+      for (auto l = 0u; l < k; ++l) {
+        auto w = d[cs[j]][cs[l]] + pi[j] + pi[l];
+        if (!inTree[l] && w < key[l]) {
+          key[l] = w;
+          parent[l] = j;
+        }
+      }
+    }
+
+    // Cheapest edges to the two ends
+    auto a = 0u;
+    auto b = 0u;
+    auto sumPi = 0.0;
+    for (auto l = 0u; l < k; ++l) {
+      if (d[from][cs[l]] + pi[l] < d[from][cs[a]] + pi[a]) {
+        a = l;
+      }
+      if (d[start][cs[l]] + pi[l] < d[start][cs[b]] + pi[b]) {
+        b = l;
+      }
+      sumPi += pi[l];
+    }
+    ++degree[a];
+    ++degree[b];
+
+    auto lb = tree + d[from][cs[a]] + pi[a] + d[start][cs[b]] + pi[b] - 2 * sumPi;
+    best = std::max(best, lb);
+    if (best >= target) {
+      break;
+    }
+
+    auto norm = 0.0;
+    for (auto l = 0u; l < k; ++l) {
+      norm += (degree[l] - 2) * (degree[l] - 2);
+    }
+    if (norm == 0) {
+      break;
+    }
+
+    // Polyak step towards the target, estimated no more than 10% above the
+    // bound so a weak incumbent can't make the steps huge
+    auto goal = std::min<double>(target, 1.1 * lb + 1);
+    auto step = lambda * (goal - lb) / norm;
+    for (auto l = 0u; l < k; ++l) {
+      pi[l] += step * (degree[l] - 2);
+    }
+    lambda *= 0.95;
+  }
+
+  // Tour lengths are integers. Allow for rounding in the penalties.
+  return std::ceil(best - 1e-6);
+}
+
+// Children extend the tour by each unvisited city. Their MST bound only
+// depends on the parent: it spans the cities left after the child plus the
+// start and the child itself, i.e. the parent's unvisited cities and the
+// start, so we compute it once for all of them.
+template <unsigned n_words_>
+struct NodeGen : YewPar::NodeGenerator<TSPNode<n_words_>, TSPSpace> {
   unsigned lastCity;
 
   std::reference_wrapper<const TSPSpace> space;
-  std::reference_wrapper<const TSPNode> parent;
+  std::reference_wrapper<const TSPNode<n_words_> > parent;
 
   unsigned nextToVisit;
+  unsigned spanningTree = 0;
+
+  // Held-Karp bounds can stop once they reach the incumbent, when we are
+  // given it (see util/NodeGenerator.hpp)
+  unsigned incumbent = UINT_MAX;
+
+  NodeGen(const TSPSpace & space, const TSPNode<n_words_> & n,
+          YewPar::IncumbentBound<unsigned> bnd) : NodeGen(space, n) {
+    incumbent = bnd.bound;
+  }
 
-  NodeGen(const TSPSpace & space, const TSPNode & n) :
+  NodeGen(const TSPSpace & space, const TSPNode<n_words_> & n) :
       space(std::cref(space)), parent(std::cref(n)) {
-    lastCity = n.sol.cities.back();
-    numChildren = n.unvisited.count();
+    lastCity = n.last();
+    this->numChildren = n.unvisited.count();
     const auto & bs = parent.get().unvisited;
-    nextToVisit = next_set<MAX_CITIES>(bs, this->space.get().numCities, 0);
+    nextToVisit = next_set(bs, this->space.get().numCities, 0);
+
+    // With one child left it completes the tour and is its own bound
+    if (!space.heldKarp && this->numChildren > 1) {
+      auto cities = n.unvisited;
+      cities.set(n.first());
+      spanningTree = mst<n_words_>(space, cities);
+    }
   }
 
-  TSPNode next() override {
+  TSPNode<n_words_> next() override {
+    const auto & s = space.get();
     auto nextCity = nextToVisit;
-    nextToVisit = next_set<MAX_CITIES>(parent.get().unvisited, space.get().numCities, nextToVisit);
+    nextToVisit = next_set(parent.get().unvisited, s.numCities, nextToVisit);
 
     // Not quite right since partial tours don't have a length
-    auto newSol = parent.get().sol;
-    newSol.cities.push_back(nextCity);
-    newSol.tourLength += space.get().distances[lastCity][nextCity];
-
-    auto newUnvisited = parent.get().unvisited;
-    newUnvisited.reset(nextCity);
+    auto child = parent.get();
+    child.cities[child.numVisited++] = nextCity;
+    child.tourLength += s.distances[lastCity][nextCity];
+    child.unvisited.reset(nextCity);
 
     // Link back to the start if we have a complete tour
-    if (newUnvisited.none()) {
-      auto start = newSol.cities.front();
-      newSol.cities.push_back(start);
-      newSol.tourLength += space.get().distances[nextCity][start];
+    if (child.unvisited.none()) {
+      auto start = child.first();
+      child.cities[child.numVisited++] = start;
+      child.tourLength += s.distances[nextCity][start];
+      child.bound = child.tourLength;
+    } else if (s.heldKarp) {
+      auto target = incumbent > child.tourLength ? incumbent - child.tourLength : 0;
+      child.bound = child.tourLength + heldKarp<n_words_>(s, nextCity, child.first(), child.unvisited, target);
+    } else {
+      child.bound = child.tourLength + spanningTree;
     }
 
-    return TSPNode { newSol, newUnvisited };
+    return child;
   }
 };
 
-// Very simple MST function, nothing fancy so not the fastest
-unsigned mst(const TSPSpace & space,
-             unsigned lastCity,
-             std::bitset<MAX_CITIES> & remCities) {
-  std::array<unsigned, MAX_CITIES> weights;
+template <unsigned n_words_>
+TSPNode<n_words_> rootNode(const TSPSpace & space) {
+  TSPNode<n_words_> root;
+  root.cities[0] = 1;
+  root.numVisited = 1;
+  root.tourLength = 0;
+  for (auto i = 2u; i <= space.numCities; ++i) {
+    root.unvisited.set(i);
+  }
 
-  auto w = 0;
-  auto minCity = 0;
-  auto minWeight = INT_MAX;
+  auto cities = root.unvisited;
+  cities.set(1);
+  root.bound = space.heldKarp ? heldKarp<n_words_>(space, 1, 1, root.unvisited, UINT_MAX)
+                              : mst<n_words_>(space, cities);
+  return root;
+}
 
-  // Set up initial weights
-  for (auto i = 1; i <= space.numCities; ++i) {
-    if (remCities.test(i)) {
-      weights[i] = space.distances[lastCity][i];
+template <unsigned n_words_>
+unsigned boundFn(const TSPSpace & space, const TSPNode<n_words_> & n) {
+  return n.bound;
+}
+
+template <unsigned n_words_>
+using upperBound_func = func<decltype(&boundFn<n_words_>), &boundFn<n_words_> >;
+
+// Warm start heuristic: a nearest neighbour tour from a random city (city 1
+// on the first run of each worker, i.e. greedyNN's tour) improved by 2-opt
+// and Or-opt moves, taking the first improving move until there is none. The
+// tour is rotated to start at city 1 like those of the search and is only
+// used as an incumbent.
+template <unsigned n_words_>
+TSPNode<n_words_> warmStartHeuristic(const TSPSpace & space, const TSPNode<n_words_> & root, std::uint64_t seed) {
+  const auto & d = space.distances;
+  const auto n = space.numCities;
+  std::mt19937_64 rand(seed);
+
+  std::vector<unsigned> tour;
+  tour.push_back((seed & 0xffffffff) == 0 ? 1 : 1 + rand() % n);
+  std::bitset<n_words_ * 64> left;
+  for (auto i = 1u; i <= n; ++i) {
+    left.set(i);
+  }
+  left.reset(tour[0]);
+  while (tour.size() < n) {
+    auto cur = tour.back();
+    auto next = 0u;
+    for (auto c = 1u; c <= n; ++c) {
+      if (left.test(c) && (next == 0 || d[cur][c] < d[cur][next])) {
+        next = c;
+      }
     }
+    tour.push_back(next);
+    left.reset(next);
   }
 
-  while (!remCities.none()) {
-    auto minWeight = INT_MAX;
-    for (auto i = 1; i <= space.numCities; ++i) {
-      if (remCities.test(i)) {
-        if (weights[i]< minWeight) {
-          minWeight = weights[i];
-          minCity = i;
+  // Moves are applied as soon as they are found (and the search for one
+  // restarted), so deltas are always relative to the current tour
+  auto improved = n > 4;
+  while (improved) {
+    improved = false;
+
+    // 2-opt: replace edges (a, b) and (c, e) with (a, c) and (b, e) by
+    // reversing b..c
+    for (auto i = 0u; i + 2 < n && !improved; ++i) {
+      for (auto j = i + 2; j < n && !improved; ++j) {
+        if (i == 0 && j == n - 1) {
+          continue;
+        }
+        auto a = tour[i], b = tour[i + 1], c = tour[j], e = tour[(j + 1) % n];
+        if (d[a][c] + d[b][e] < d[a][b] + d[c][e]) {
+          std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+          improved = true;
         }
       }
     }
 
-    w += minWeight;
-    remCities.reset(minCity);
-
-    // Update weights
-      for (auto i = 1; i <= space.numCities; ++i) {
-        if (remCities.test(i)) {
-          auto dist = space.distances[minCity][i];
-          if (dist < weights[i]) {
-            weights[i] = dist;
+    // Or-opt: move a segment of up to three cities, possibly reversed,
+    // between two other neighbouring cities
+    for (auto len = 1u; len <= 3 && len + 2 < n && !improved; ++len) {
+      for (auto i = 0u; i + len <= n && !improved; ++i) {
+        auto first = tour[i], last = tour[i + len - 1];
+        auto p = tour[(i + n - 1) % n], q = tour[(i + len) % n];
+        long removed = (long) d[p][first] + d[last][q] - d[p][q];
+
+        for (auto k = 0u; k < n && !improved; ++k) {
+          // Edges touching the segment (including the one before it)
+          if ((k + n - i + 1) % n <= len) {
+            continue;
+          }
+          auto x = tour[k], y = tour[(k + 1) % n];
+          long forward = (long) d[x][first] + d[last][y] - d[x][y];
+          long reversed = (long) d[x][last] + d[first][y] - d[x][y];
+          if (std::min(forward, reversed) < removed) {
+            std::vector<unsigned> segment(tour.begin() + i, tour.begin() + i + len);
+            if (reversed < forward) {
+              std::reverse(segment.begin(), segment.end());
+            }
+            tour.erase(tour.begin() + i, tour.begin() + i + len);
+            auto at = std::find(tour.begin(), tour.end(), x) + 1;
+            tour.insert(at, segment.begin(), segment.end());
+            improved = true;
           }
         }
       }
+    }
   }
 
-  return w;
-}
+  std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), 1u), tour.end());
+  tour.push_back(1);
 
-unsigned boundFn(const TSPSpace & space, const TSPNode & n) {
-  std::bitset<MAX_CITIES> nodes = n.unvisited;
-  nodes.set(n.sol.cities.front());
-  return n.sol.tourLength + mst(space, n.sol.cities.back(), nodes);
+  auto sol = root;
+  sol.numVisited = 0;
+  sol.tourLength = 0;
+  for (auto i = 0u; i < tour.size(); ++i) {
+    sol.cities[sol.numVisited++] = tour[i];
+    if (i > 0) {
+      sol.tourLength += d[tour[i - 1]][tour[i]];
+    }
+  }
+  sol.unvisited.reset();
+  sol.bound = sol.tourLength;
+  return sol;
 }
 
-typedef func<decltype(&boundFn), &boundFn> upperBound_func;
+template <unsigned n_words_>
+using warmStart_func = func<decltype(&warmStartHeuristic<n_words_>), &warmStartHeuristic<n_words_> >;
 
-unsigned greedyNN(const DistanceMatrix<MAX_CITIES> & distances,
+unsigned greedyNN(const DistanceMatrix & distances,
                   const std::vector<unsigned> & cities,
                   const unsigned startingCity) {
   unsigned dist = 0;
@@ -177,7 +465,7 @@ unsigned greedyNN(const DistanceMatrix<MAX_CITIES> & distances,
 
   while (!rem.empty()) {
     auto nextCity = *(std::min_element(rem.begin(), rem.end(),
-                                       [curCity, distances](const unsigned & x, const unsigned & y){
+                                       [curCity, &distances](const unsigned & x, const unsigned & y){
                                          return distances[curCity][x] < distances[curCity][y];
                                        }));
     dist += distances[curCity][nextCity];
@@ -193,7 +481,7 @@ unsigned greedyNN(const DistanceMatrix<MAX_CITIES> & distances,
 
 
 // TSP helper functions
-unsigned calculateTourLength(const DistanceMatrix<MAX_CITIES> & distances,
+unsigned calculateTourLength(const DistanceMatrix & distances,
                              const std::vector<unsigned> & cities) {
   auto l = 0;
   for (auto i = 0; i < cities.size() - 1; ++i) {
@@ -202,60 +490,48 @@ unsigned calculateTourLength(const DistanceMatrix<MAX_CITIES> & distances,
   return l;
 }
 
-int hpx_main(boost::program_options::variables_map & opts) {
-  auto inputFile = opts["input-file"].as<std::string>();
-
-  TSPFromFile inputData;
-  try {
-    inputData = parseFile(inputFile);
-  } catch (SomethingWentWrong & e) {
-    std::cerr << e.what() << hpx::endl;
-    hpx::finalize();
-  }
-
-  DistanceMatrix<MAX_CITIES> distances;
-  if (inputData.type == TSP_TYPE::EUC_2D) {
-    distances = buildDistanceMatrixEUC2D<MAX_CITIES>(inputData);
-  } else {
-    distances = buildDistanceMatrixGEO<MAX_CITIES>(inputData);
-  }
-
-  std::vector<unsigned> initialTour {1};
-  std::bitset<MAX_CITIES> unvisited;
-
-  for (auto i = 2; i <= inputData.numNodes; ++i) {
-    unvisited.set(i);
-  }
+template <unsigned n_words_>
+int search(const TSPSpace & space, boost::program_options::variables_map & opts) {
+  using upperBound_func = ::upperBound_func<n_words_>;
+  using NodeGen = ::NodeGen<n_words_>;
+  using warmStart_func = ::warmStart_func<n_words_>;
 
   auto start_time = std::chrono::steady_clock::now();
 
-  TSPSpace space { distances , inputData.numNodes };
-  TSPSol initSol { initialTour, 0};
-  TSPNode root { initSol, unvisited };
+  auto root = rootNode<n_words_>(space);
 
   auto skeletonType = opts["skeleton"].as<std::string>();
   auto spawnDepth = opts["spawn-depth"].as<unsigned>();
   auto sol = root;
 
-  // Init the bound to a greedy nearest neighbour search
-  std::vector<unsigned> allCities(inputData.numNodes + 1);
+  // Init the bound to a greedy nearest neighbour search. A warm start
+  // improves on that tour and keeps it as the incumbent (so it is reported
+  // if it turns out to be optimal), so then we start with no bound at all.
+  std::vector<unsigned> allCities(space.numCities);
   std::iota(allCities.begin(), allCities.end(), 1);
   YewPar::Skeletons::API::Params<unsigned> searchParameters;
-  searchParameters.initialBound = greedyNN(distances, allCities, 1);
+  searchParameters.warmStartTime = opts["warm-start-time"].as<unsigned>();
+  if (searchParameters.warmStartTime == 0) {
+    searchParameters.initialBound = greedyNN(space.distances, allCities, 1);
+  } else {
+    searchParameters.initialBound = UINT_MAX;
+  }
 
   if (skeletonType == "seq") {
 
     sol = YewPar::Skeletons::Seq<NodeGen,
                                  YewPar::Skeletons::API::Optimisation,
                                  YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                 YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                 YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                 YewPar::Skeletons::API::WarmStart<warmStart_func> >
         ::search(space, root, searchParameters);
   } else if (skeletonType == "depthbounded") {
     searchParameters.spawnDepth = spawnDepth;
     sol = YewPar::Skeletons::DepthBounded<NodeGen,
                                          YewPar::Skeletons::API::Optimisation,
                                          YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                         YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                         YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                         YewPar::Skeletons::API::WarmStart<warmStart_func> >
                ::search(space, root, searchParameters);
   } else if (skeletonType == "ordered") {
     searchParameters.spawnDepth = spawnDepth;
@@ -264,13 +540,15 @@ int hpx_main(boost::program_options::variables_map & opts) {
                                       YewPar::Skeletons::API::Optimisation,
                                       YewPar::Skeletons::API::DiscrepancySearch,
                                       YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                      YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                      YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                      YewPar::Skeletons::API::WarmStart<warmStart_func> >
                 ::search(space, root, searchParameters);
     } else {
       sol = YewPar::Skeletons::Ordered<NodeGen,
                                       YewPar::Skeletons::API::Optimisation,
                                       YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                      YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                      YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                      YewPar::Skeletons::API::WarmStart<warmStart_func> >
                 ::search(space, root, searchParameters);
     }
   } else if (skeletonType == "budget") {
@@ -278,14 +556,16 @@ int hpx_main(boost::program_options::variables_map & opts) {
     sol = YewPar::Skeletons::Budget<NodeGen,
                                     YewPar::Skeletons::API::Optimisation,
                                     YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                    YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                    YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                    YewPar::Skeletons::API::WarmStart<warmStart_func> >
         ::search(space, root, searchParameters);
   } else if (skeletonType == "stacksteal") {
     searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
     sol = YewPar::Skeletons::StackStealing<NodeGen,
                                            YewPar::Skeletons::API::Optimisation,
                                            YewPar::Skeletons::API::BoundFunction<upperBound_func>,
-                                           YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>>
+                                           YewPar::Skeletons::API::ObjectiveComparison<std::less<unsigned>>,
+                                           YewPar::Skeletons::API::WarmStart<warmStart_func> >
         ::search(space, root, searchParameters);
   } else {
     hpx::cout << "Invalid skeleton type\n";
@@ -296,17 +576,63 @@ int hpx_main(boost::program_options::variables_map & opts) {
                       (std::chrono::steady_clock::now() - start_time);
 
   hpx::cout << "Tour: ";
-  for (const auto c : sol.sol.cities) {
-    hpx::cout << c << ",";
+  for (auto i = 0u; i < sol.numVisited; ++i) {
+    hpx::cout << sol.cities[i] << ",";
   }
   hpx::cout << hpx::endl;
-  hpx::cout << "Optimal tour length: " << sol.sol.tourLength << "\n";
+  hpx::cout << "Optimal tour length: " << sol.tourLength << "\n";
 
   hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
 
   return hpx::finalize();
 }
 
+// Search with the smallest size class that fits the cities (numbered from 1),
+// doubling up to NWORDS
+template <unsigned n_words_>
+int searchSizeClass(const TSPSpace & space, boost::program_options::variables_map & opts) {
+  if (space.numCities < n_words_ * 64) {
+    return search<n_words_>(space, opts);
+  }
+
+  if constexpr (n_words_ < NWORDS) {
+    return searchSizeClass<std::min(n_words_ * 2, static_cast<unsigned>(NWORDS))>(space, opts);
+  } else {
+    hpx::cout << "Binary Cannot Handle Instance of this size. Recompile with a bigger NWORDS" << hpx::endl;
+    hpx::finalize();
+    return EXIT_FAILURE;
+  }
+}
+
+int hpx_main(boost::program_options::variables_map & opts) {
+  auto inputFile = opts["input-file"].as<std::string>();
+
+  TSPFromFile inputData;
+  try {
+    inputData = parseFile(inputFile);
+  } catch (SomethingWentWrong & e) {
+    std::cerr << e.what() << hpx::endl;
+    hpx::finalize();
+  }
+
+  DistanceMatrix distances;
+  if (inputData.type == TSP_TYPE::EUC_2D) {
+    distances = buildDistanceMatrixEUC2D(inputData);
+  } else {
+    distances = buildDistanceMatrixGEO(inputData);
+  }
+
+  auto boundType = opts["bound"].as<std::string>();
+  if (boundType != "mst" && boundType != "hk") {
+    hpx::cout << "Invalid bound type\n";
+    return hpx::finalize();
+  }
+
+  TSPSpace space { distances , inputData.numNodes, boundType == "hk",
+                   opts["hk-iterations"].as<unsigned>() };
+  return searchSizeClass<1>(space, opts);
+}
+
 int main(int argc, char* argv[]) {
   boost::program_options::options_description
       desc_commandline("Usage: " HPX_APPLICATION_STRING " [options]");
@@ -326,6 +652,18 @@ int main(int argc, char* argv[]) {
         )
        ("discrepancyOrder", "Use discrepancy order for the ordered skeleton")
        ("chunked", "Use chunking with stack stealing")
+       ( "bound",
+        boost::program_options::value<std::string>()->default_value("mst"),
+        "Bound function: mst or hk (Held-Karp)"
+        )
+       ( "hk-iterations",
+        boost::program_options::value<unsigned>()->default_value(30),
+        "Subgradient iterations per Held-Karp bound"
+        )
+       ( "warm-start-time",
+        boost::program_options::value<unsigned>()->default_value(0),
+        "Time (ms) to run the nearest neighbour/2-opt/Or-opt heuristic on every worker for an initial incumbent"
+        )
        ( "spawn-depth,d",
         boost::program_options::value<unsigned>()->default_value(0),
         "Depth in the tree to spawn until (for parallel skeletons only)"
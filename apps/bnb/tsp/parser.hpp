@@ -6,6 +6,7 @@
 #include <fstream>
 #include <regex>
 #include <cmath>
+#include <vector>
 
 enum TSP_TYPE {
   EUC_2D, GEO
@@ -31,12 +32,38 @@ struct TSPFromFile {
 };
 
 TSPFromFile parseFile (const std::string & filename);
-template<unsigned N>
-using DistanceMatrix = std::array<std::array<unsigned, N>, N>;
 
-template<unsigned N>
-DistanceMatrix<N> buildDistanceMatrixEUC2D (const TSPFromFile & data) {
-  DistanceMatrix<N> costs;
+// Distances between cities, stored flat and sized to the instance. Cities are
+// numbered from 1 so row and column 0 are unused. distances[i][j] reads as it
+// would for a 2D array.
+class DistanceMatrix {
+ private:
+  unsigned stride = 0;
+  std::vector<unsigned> costs;
+
+ public:
+  DistanceMatrix() = default;
+
+  explicit DistanceMatrix(unsigned numCities) :
+      stride(numCities + 1), costs(stride * stride, 0) {}
+
+  const unsigned * operator[](unsigned i) const {
+    return costs.data() + i * stride;
+  }
+
+  unsigned * operator[](unsigned i) {
+    return costs.data() + i * stride;
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & stride;
+    ar & costs;
+  }
+};
+
+inline DistanceMatrix buildDistanceMatrixEUC2D (const TSPFromFile & data) {
+  DistanceMatrix costs(data.numNodes);
   for (const auto & n1 : data.nodeInfo) {
     for (const auto & n2 : data.nodeInfo) {
       if (n1.first == n2.first) {
@@ -54,9 +81,8 @@ DistanceMatrix<N> buildDistanceMatrixEUC2D (const TSPFromFile & data) {
 
 unsigned calculateDistanceLatLon(std::pair<double, double> n1, std::pair<double, double> n2);
 
-template<unsigned N>
-DistanceMatrix<N> buildDistanceMatrixGEO (const TSPFromFile & data) {
-  DistanceMatrix<N> costs;
+inline DistanceMatrix buildDistanceMatrixGEO (const TSPFromFile & data) {
+  DistanceMatrix costs(data.numNodes);
 
   for (const auto & n1 : data.nodeInfo) {
     for (const auto & n2 : data.nodeInfo) {
@@ -2,14 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <functional>
 #include <limits>
 #include <list>
 #include <map>
 #include <numeric>
 #include <random>
-#include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <chrono>
 
 #include "YewPar.hpp"
@@ -19,15 +21,16 @@
 #include "skeletons/StackStealing.hpp"
 #include "skeletons/Ordered.hpp"
 #include "skeletons/Budget.hpp"
+#include "skeletons/Restarts.hpp"
 
 #include "util/func.hpp"
 #include "util/NodeGenerator.hpp"
+#include "util/GraphCache.hpp"
 
 #include "lad.hh"
 #include "fixed_bit_set.hh"
 
 #include <hpx/hpx_init.hpp>
-#include <hpx/util/tuple.hpp>
 #include <hpx/include/iostreams.hpp>
 
 #ifndef NWORDS
@@ -38,7 +41,6 @@ using std::array;
 using std::iota;
 using std::fill;
 using std::find_if;
-using std::get;
 using std::greater;
 using std::list;
 using std::max;
@@ -54,10 +56,9 @@ using std::swap;
 using std::to_string;
 using std::uniform_int_distribution;
 using std::uniform_real_distribution;
+using std::unordered_map;
 using std::vector;
 
-using hpx::util::tuple;
-
 using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 using std::chrono::steady_clock;
@@ -86,16 +87,31 @@ struct Assignment {
   }
 };
 
+// The value of each pattern vertex, indexed by vertex. Sized once for the
+// pattern so lookups and assignments are constant time.
 struct Assignments {
-    vector<tuple<Assignment, bool> > values;
+  static constexpr unsigned unassigned = numeric_limits<unsigned>::max();
 
-    bool contains(const Assignment & assignment) const
-    {
-        // this should not be a linear scan...
-        return values.end() != find_if(values.begin(), values.end(), [&] (const auto & a) {
-                return get<0>(a).variable == assignment.variable && get<0>(a).value == assignment.value;
-                });
-    }
+  vector<unsigned> values;
+
+  Assignments() = default;
+
+  explicit Assignments(unsigned pattern_size) : values(pattern_size, unassigned) {}
+
+  bool contains(const Assignment & assignment) const
+  {
+    return values[assignment.variable] == assignment.value;
+  }
+
+  bool assigned(unsigned variable) const
+  {
+    return values[variable] != unassigned;
+  }
+
+  void assign(const Assignment & assignment)
+  {
+    values[assignment.variable] = assignment.value;
+  }
 
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
@@ -210,6 +226,58 @@ int largest_target_degree;
             pattern_adjacencies_bits(i, j) |= (1u << g);
   }
 
+  // Sections of a model cache (see util/GraphCache.hpp), degrees are
+  // flattened one graph after another
+  enum CacheSection { Sizes, PatternAdjacencies, PatternRows, TargetRows, PatternPermutation,
+                      TargetPermutation, IsolatedVertices, PatternDegrees, TargetDegrees, NumCacheSections };
+
+  // Load a model written by write_cache. Everything is bulk copied, nothing
+  // is recomputed.
+  Model(const YewPar::util::GraphCache & cache) :
+      _pattern_adjacencies_bits(cache.copySection<uint8_t>(PatternAdjacencies)),
+      pattern_graph_rows(cache.copySection<FixedBitSet<n_words_> >(PatternRows)),
+      target_graph_rows(cache.copySection<FixedBitSet<n_words_> >(TargetRows)),
+      pattern_permutation(cache.copySection<int>(PatternPermutation)),
+      target_permutation(cache.copySection<int>(TargetPermutation)),
+      isolated_vertices(cache.copySection<int>(IsolatedVertices))
+  {
+    auto sizes = cache.section<int>(Sizes).first;
+    max_graphs = sizes[0];
+    pattern_size = sizes[1];
+    full_pattern_size = sizes[2];
+    target_size = sizes[3];
+    largest_target_degree = sizes[4];
+
+    auto pattern_degrees = cache.section<int>(PatternDegrees).first;
+    auto target_degrees = cache.section<int>(TargetDegrees).first;
+    for (int g = 0 ; g < max_graphs ; ++g) {
+      patterns_degrees.emplace_back(pattern_degrees + g * pattern_size, pattern_degrees + (g + 1) * pattern_size);
+      targets_degrees.emplace_back(target_degrees + g * target_size, target_degrees + (g + 1) * target_size);
+    }
+  }
+
+  auto write_cache(const std::string & path, std::uint64_t key) const -> bool
+  {
+    int sizes[] = { max_graphs, int(pattern_size), int(full_pattern_size), int(target_size), largest_target_degree };
+    vector<int> pattern_degrees, target_degrees;
+    for (int g = 0 ; g < max_graphs ; ++g) {
+      pattern_degrees.insert(pattern_degrees.end(), patterns_degrees[g].begin(), patterns_degrees[g].end());
+      target_degrees.insert(target_degrees.end(), targets_degrees[g].begin(), targets_degrees[g].end());
+    }
+
+    YewPar::util::GraphCacheWriter cache;
+    cache.add(sizes, 5);
+    cache.add(_pattern_adjacencies_bits);
+    cache.add(pattern_graph_rows);
+    cache.add(target_graph_rows);
+    cache.add(pattern_permutation);
+    cache.add(target_permutation);
+    cache.add(isolated_vertices);
+    cache.add(pattern_degrees);
+    cache.add(target_degrees);
+    return cache.write(path, key);
+  }
+
   auto pattern_adjacencies_bits(unsigned i, unsigned j) -> uint8_t &
   {
     return _pattern_adjacencies_bits[i * pattern_size + j];
@@ -271,13 +339,8 @@ int largest_target_degree;
   }
 };
 
-template <unsigned n_words_>
-auto find_unit_domain(Domains<n_words_> & domains) -> typename Domains<n_words_>::iterator
-{
-  return find_if(domains.begin(), domains.end(), [] (Domain<n_words_> & d) {
-      return (! d.fixed) && 1 == d.popcount;
-    });
-}
+// Pattern adjacencies in each graph are the bits of a uint8_t
+static const constexpr int max_supported_graphs = 8;
 
 // The max_graphs_ template parameter is so that the for each graph
 // pair loop gets unrolled, which makes an annoyingly large difference
@@ -287,10 +350,9 @@ template <unsigned n_words_, int max_graphs_>
 auto propagate_adjacency_constraints(
     const Model<n_words_> & m,
     Domain<n_words_> & d,
-    const Assignment & current_assignment) -> void
+    const Assignment & current_assignment,
+    uint8_t pattern_adjacency_bits) -> void
 {
-  auto pattern_adjacency_bits = m.pattern_adjacencies_bits(current_assignment.variable, d.v);
-
   // for each graph pair...
   for (int g = 0 ; g < max_graphs_ ; ++g) {
     // if we're adjacent...
@@ -301,33 +363,68 @@ auto propagate_adjacency_constraints(
   }
 }
 
+// Pick the unrolled propagate_adjacency_constraints for the model's number
+// of graphs, counting down from the most we support
+template <unsigned n_words_, int max_graphs_ = max_supported_graphs>
+auto propagate_adjacency_constraints_for(
+    const Model<n_words_> & m,
+    Domain<n_words_> & d,
+    const Assignment & current_assignment,
+    uint8_t pattern_adjacency_bits) -> void
+{
+  if constexpr (max_graphs_ > 1) {
+    if (m.max_graphs < max_graphs_)
+      return propagate_adjacency_constraints_for<n_words_, max_graphs_ - 1>(m, d, current_assignment, pattern_adjacency_bits);
+  }
+  propagate_adjacency_constraints<n_words_, max_graphs_>(m, d, current_assignment, pattern_adjacency_bits);
+}
+
+// Domains reduced to a single value are added to units (by index), so the
+// caller never has to look for them.
+//
+// Every domain is visited, not just those adjacent to the assigned vertex: all
+// different touches them all anyway, and a non-adjacent domain only costs a
+// bit test. Visiting just the neighbours (with a vertex to domain index) and
+// leaving all different to cheap_all_different was measured as 5-20% slower,
+// as the supplemental graphs make most pattern vertices adjacent.
 template <unsigned n_words_>
 auto propagate_simple_constraints(
     const Model<n_words_> & m,
     Domains<n_words_> & new_domains,
-    const Assignment & current_assignment) -> bool
+    const Assignment & current_assignment,
+    FixedBitSet<n_words_> & units) -> bool
 {
   // propagate for each remaining domain...
-  for (auto & d : new_domains) {
+  for (unsigned i = 0 ; i < new_domains.size() ; ++i) {
+    auto & d = new_domains[i];
     if (d.fixed)
       continue;
 
-    // all different
-    d.values.unset(current_assignment.value);
+    auto old_popcount = d.popcount;
+    auto pattern_adjacency_bits = m.pattern_adjacencies_bits(current_assignment.variable, d.v);
+    if (0 == pattern_adjacency_bits) {
+      // not adjacent in any graph, so only all different can remove a
+      // value and we can keep count without a popcount
+      if (d.values.test(current_assignment.value)) {
+        d.values.unset(current_assignment.value);
+        --d.popcount;
+      }
+    }
+    else {
+      // all different
+      d.values.unset(current_assignment.value);
 
-    // adjacency
-    switch (m.max_graphs) {
-      case 5: propagate_adjacency_constraints<n_words_, 5>(m, d, current_assignment); break;
-      case 6: propagate_adjacency_constraints<n_words_, 6>(m, d, current_assignment); break;
+      // adjacency
+      propagate_adjacency_constraints_for(m, d, current_assignment, pattern_adjacency_bits);
 
-      default:
-        throw "you forgot to update the ugly max_graphs hack";
+      // we might have removed values
+      d.popcount = d.values.popcount();
     }
 
-    // we might have removed values
-    d.popcount = d.values.popcount();
     if (0 == d.popcount)
       return false;
+    if (1 == d.popcount && 1 != old_popcount)
+      units.set(i);
   }
 
   return true;
@@ -339,25 +436,32 @@ auto propagate(
     Domains<n_words_> & new_domains,
     Assignments & assignments) -> bool
 {
+  // Unit domains not yet assigned, by index. After this scan the
+  // propagators add domains as they become unit, and the lowest index is
+  // always assigned first.
+  FixedBitSet<n_words_> units;
+  for (unsigned i = 0 ; i < new_domains.size() ; ++i)
+    if ((! new_domains[i].fixed) && 1 == new_domains[i].popcount)
+      units.set(i);
+
   // whilst we've got a unit domain...
-  for (typename Domains<n_words_>::iterator branch_domain = find_unit_domain(new_domains) ;
-       branch_domain != new_domains.end() ;
-       branch_domain = find_unit_domain(new_domains)) {
+  for (int i = units.first_set_bit() ; i != -1 ; i = units.first_set_bit()) {
+    units.unset(i);
+    auto & branch_domain = new_domains[i];
 
     // what are we assigning?
-    Assignment current_assignment = { branch_domain->v, branch_domain->values.first_set_bit() };
+    Assignment current_assignment = { branch_domain.v, unsigned(branch_domain.values.first_set_bit()) };
 
     // ok, make the assignment
-    branch_domain->fixed = true;
-    assignments.values.push_back(hpx::util::make_tuple(current_assignment, false));
-    //assignments.values.push_back({ current_assignment.variable, current_assignment.value}, false });
+    branch_domain.fixed = true;
+    assignments.assign(current_assignment);
 
     // propagate simple all different and adjacency
-    if (! propagate_simple_constraints(m, new_domains, current_assignment))
+    if (! propagate_simple_constraints(m, new_domains, current_assignment, units))
       return false;
 
     // propagate all different
-    if (! cheap_all_different(new_domains))
+    if (! cheap_all_different(new_domains, units))
       return false;
   }
 
@@ -486,8 +590,9 @@ auto initialise_domains(
   return true;
 }
 
+// Domains (not yet fixed) reduced to a single value are added to units
 template <unsigned n_words_>
-auto cheap_all_different(Domains<n_words_> & domains) -> bool
+auto cheap_all_different(Domains<n_words_> & domains, FixedBitSet<n_words_> & units) -> bool
 {
   // Pick domains smallest first; ties are broken by smallest .v first.
   // For each popcount p we have a linked list, whose first member is
@@ -510,8 +615,10 @@ auto cheap_all_different(Domains<n_words_> & domains) -> bool
     first.at(popcount) = i;
   }
 
-  // counting all-different
+  // counting all-different. Popcounts are kept up to date, so until we
+  // find a hall set there is nothing to remove or recount.
   FixedBitSet<n_words_> domains_so_far, hall;
+  bool hall_empty = true;
   unsigned neighbours_so_far = 0;
 
   for (unsigned i = 0 ; i <= domains.size() ; ++i) {
@@ -520,11 +627,15 @@ auto cheap_all_different(Domains<n_words_> & domains) -> bool
     while (domain_index != -1) {
       auto & d = domains.at(domain_index);
 
-      d.values.intersect_with_complement(hall);
-      d.popcount = d.values.popcount();
+      if (! hall_empty) {
+        auto old_popcount = d.popcount;
+        d.popcount = d.values.intersect_with_complement_and_popcount(hall);
 
-      if (0 == d.popcount)
-        return false;
+        if (0 == d.popcount)
+          return false;
+        if (1 == d.popcount && 1 != old_popcount && ! d.fixed)
+          units.set(domain_index);
+      }
 
       domains_so_far.union_with(d.values);
       ++neighbours_so_far;
@@ -536,6 +647,7 @@ auto cheap_all_different(Domains<n_words_> & domains) -> bool
       else if (domains_so_far_popcount == neighbours_so_far) {
         // equivalent to hall=domains_so_far
         hall.union_with(domains_so_far);
+        hall_empty = false;
       }
       domain_index = next[domain_index];
     }
@@ -552,30 +664,148 @@ struct SIPNode {
 
   bool sat;
 
+  // The branching assignment that made this node, for learning nogoods with
+  // the restarts skeleton
+  typedef Assignment Decision;
+  Assignment branch = { 0, 0 };
+
   SIPNode() = default;
 
   SIPNode(Domains<n_words_> domains, Assignments assignments) :
-      domains(domains), assignments(assignments), propagationSuccess(true), sat(false) {};
+      domains(std::move(domains)), assignments(std::move(assignments)), propagationSuccess(true), sat(false) {};
   SIPNode(Domains<n_words_> domains, Assignments assignments, bool propagationSuccess) :
-      domains(domains), assignments(assignments), propagationSuccess(propagationSuccess), sat(false) {};
+      domains(std::move(domains)), assignments(std::move(assignments)), propagationSuccess(propagationSuccess), sat(false) {};
 
   // If we are SAT then we don't really care about initialising other stuff since it's not used
-  SIPNode(Assignments assignments,  bool sat) : assignments(assignments), sat(sat) {};
+  SIPNode(Assignments assignments,  bool sat) : assignments(std::move(assignments)), sat(sat) {};
 
   bool getObj() const {
     return sat;
   }
 
+  Decision decision() const {
+    return branch;
+  }
+
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
     ar & domains;
     ar & assignments;
     ar & propagationSuccess;
     ar & sat;
-
+    ar & branch;
   }
 };
 
+// Nogoods learned by the restarts skeleton. A nogood whose assignments all
+// hold fails a node, if all but one hold the value of the other is removed
+// from its domain. Either way at least one of any two of its assignments
+// holds, so nogoods are only looked up by their last two (the deepest
+// decisions, so the least likely to hold).
+template <unsigned n_words_>
+class SIPNogoods
+{
+  private:
+    vector<vector<Assignment> > nogoods;
+
+    // nogoods by their watched assignments, keyed by variable << 32 | value
+    unordered_map<uint64_t, vector<unsigned> > watches;
+
+    // nogoods of one assignment always remove their value
+    vector<Assignment> units;
+
+    static auto key(const Assignment & a) -> uint64_t
+    {
+      return (uint64_t(a.variable) << 32) | a.value;
+    }
+
+    // Remove a value from an unassigned variable's domain, false on a wipeout
+    static auto remove(SIPNode<n_words_> & n, const Assignment & a, bool & changed) -> bool
+    {
+      if (n.assignments.assigned(a.variable))
+        return true;
+
+      auto d = find_if(n.domains.begin(), n.domains.end(), [&] (const Domain<n_words_> & d) {
+          return d.v == a.variable;
+        });
+      if (! d->values.test(a.value))
+        return true;
+
+      d->values.unset(a.value);
+      changed = true;
+      return 0 != --d->popcount;
+    }
+
+  public:
+    SIPNogoods(const Model<n_words_> &)
+    {
+    }
+
+    auto add(const vector<Assignment> & nogood) -> void
+    {
+      if (1 == nogood.size())
+        units.push_back(nogood[0]);
+      else {
+        watches[key(nogood[nogood.size() - 1])].push_back(nogoods.size());
+        watches[key(nogood[nogood.size() - 2])].push_back(nogoods.size());
+        nogoods.push_back(nogood);
+      }
+    }
+
+    auto propagate(const Model<n_words_> & m, SIPNode<n_words_> & n) const -> bool
+    {
+      if (! n.propagationSuccess)
+        return false;
+
+      bool changed = true;
+      while (changed) {
+        changed = false;
+
+        for (auto & a : units)
+          if (! remove(n, a, changed)) {
+            n.propagationSuccess = false;
+            return false;
+          }
+
+        for (unsigned v = 0 ; v < n.assignments.values.size() ; ++v) {
+          if (! n.assignments.assigned(v))
+            continue;
+
+          auto w = watches.find(key({ v, n.assignments.values[v] }));
+          if (w == watches.end())
+            continue;
+
+          for (auto i : w->second) {
+            // the one assignment that doesn't hold yet, if there is only one
+            const Assignment * open = nullptr;
+            bool all_but_one = true;
+            for (auto & a : nogoods[i]) {
+              if (n.assignments.contains(a))
+                continue;
+              if (n.assignments.assigned(a.variable) || open) {
+                all_but_one = false;
+                break;
+              }
+              open = &a;
+            }
+
+            if (all_but_one && ((! open) || ! remove(n, *open, changed))) {
+              n.propagationSuccess = false;
+              return false;
+            }
+          }
+        }
+
+        if (changed && ! ::propagate(m, n.domains, n.assignments)) {
+          n.propagationSuccess = false;
+          return false;
+        }
+      }
+
+      return true;
+    }
+};
+
 template <unsigned n_words_>
 struct GenNode : YewPar::NodeGenerator<SIPNode<n_words_>, Model<n_words_>> {
   const Domain<n_words_> * branch_domain;
@@ -591,7 +821,10 @@ struct GenNode : YewPar::NodeGenerator<SIPNode<n_words_>, Model<n_words_>> {
   std::reference_wrapper<const Model<n_words_> > model;
   std::reference_wrapper<const SIPNode<n_words_> > parent;
 
-  GenNode(const Model<n_words_> & m, const SIPNode<n_words_> & n) :
+  GenNode(const Model<n_words_> & m, const SIPNode<n_words_> & n) : GenNode(m, n, 0) {}
+
+  // A non zero seed randomises the value order (for the restarts skeleton)
+  GenNode(const Model<n_words_> & m, const SIPNode<n_words_> & n, std::uint64_t seed) :
     model(std::cref(m)), parent(std::cref(n)) {
 
     if (!parent.get().propagationSuccess) {
@@ -611,6 +844,22 @@ struct GenNode : YewPar::NodeGenerator<SIPNode<n_words_>, Model<n_words_>> {
           branch_v[branch_v_end++] = f_v;
         }
 
+        // Values are in decreasing degree order, which random orders still
+        // favour: a weighted shuffle (Efraimidis and Spirakis) with each
+        // value weighted by 2^degree, relative to the first value's
+        if (seed != 0) {
+          const auto & degrees = model.get().targets_degrees[0];
+          std::mt19937_64 rand(seed);
+          uniform_real_distribution<double> dist(0.0, 1.0);
+
+          vector<pair<double, unsigned> > keys;
+          for (unsigned i = 0 ; i < branch_v_end ; ++i)
+            keys.emplace_back(std::ldexp(std::log(1.0 - dist(rand)), degrees[branch_v[0]] - degrees[branch_v[i]]), branch_v[i]);
+          std::stable_sort(keys.begin(), keys.end(), [] (const auto & a, const auto & b) { return a.first > b.first; });
+          for (unsigned i = 0 ; i < branch_v_end ; ++i)
+            branch_v[i] = keys[i].second;
+        }
+
         f_v = 0;
         this->numChildren = branch_v_end;
       }
@@ -621,35 +870,61 @@ struct GenNode : YewPar::NodeGenerator<SIPNode<n_words_>, Model<n_words_>> {
   SIPNode<n_words_> next() override {
     if (sat) { return SIPNode<n_words_>(parent.get().assignments, true); }
 
-    // We need to do the copy in case we are running in parallel
+    // The child owns its state (it may be run on another worker), but the
+    // parent's unfixed domains are copied straight into it, once, and
+    // propagated in place
+    Assignment branch = { branch_domain->v, branch_v[f_v] };
     auto newAssignments = parent.get().assignments;
-    Assignment a {branch_domain->v, branch_v[f_v]};
-    newAssignments.values.push_back(hpx::util::make_tuple(std::move(a), true));
+    newAssignments.assign(branch);
 
-    auto dom = parent.get().domains;
-    auto new_domains = copy_domains_and_assign(dom, branch_domain->v, branch_v[f_v]);
+    auto new_domains = copy_domains_and_assign(parent.get().domains, branch.variable, branch.value);
 
     auto prop = propagate(model.get(), new_domains, newAssignments);
 
     ++f_v;
 
-    //return SIPNode<n_words_>(std::move(new_domains), std::move(newAssignments), prop);
-    return SIPNode<n_words_>(new_domains, std::move(newAssignments), prop);
+    SIPNode<n_words_> child(std::move(new_domains), std::move(newAssignments), prop);
+    child.branch = branch;
+    return child;
   }
 };
 
 int hpx_main(boost::program_options::variables_map & opts) {
   hpx::cout << "Using pattern file: " << opts["pattern"].as<std::string>() << hpx::endl;
   hpx::cout << "Using target file: " << opts["target"].as<std::string>() << hpx::endl;
-  auto patternG = read_lad(opts["pattern"].as<std::string>());
-  auto targetG  = read_lad(opts["target"].as<std::string>());
-
-  if (patternG.size() > targetG.size()) {
-    std::cerr << "Pattern graph larger than Target graph\n";
-    return hpx::finalize();
+  // With a model cache the preprocessed model (orderings, supplemental
+  // graphs, degrees) is read from the cache file, the LAD files are only
+  // parsed and preprocessed when the cache is missing or stale
+  std::shared_ptr<const YewPar::util::GraphCache> cache;
+  std::uint64_t cacheKey = 0;
+  if (opts.count("model-cache")) {
+    cacheKey = YewPar::util::cacheKey("sip", {YewPar::util::fileStamp(opts["pattern"].as<std::string>()),
+                                              YewPar::util::fileStamp(opts["target"].as<std::string>()),
+                                              NWORDS, simd_words, bits_per_word});
+    cache = YewPar::util::GraphCache::open(opts["model-cache"].as<std::string>(), cacheKey);
+    if (cache && cache->sections() != Model<NWORDS>::NumCacheSections) {
+      cache.reset();
+    }
   }
 
-  const Model<NWORDS> m(targetG, patternG);
+  Model<NWORDS> m;
+  if (cache) {
+    m = Model<NWORDS>(*cache);
+  } else {
+    auto patternG = read_lad(opts["pattern"].as<std::string>());
+    auto targetG  = read_lad(opts["target"].as<std::string>());
+
+    if (patternG.size() > targetG.size()) {
+      std::cerr << "Pattern graph larger than Target graph\n";
+      return hpx::finalize();
+    }
+
+    m = Model<NWORDS>(targetG, patternG);
+
+    if (opts.count("model-cache") && !m.write_cache(opts["model-cache"].as<std::string>(), cacheKey)) {
+      std::cerr << "Could not write model cache " << opts["model-cache"].as<std::string>() << "\n";
+    }
+  }
 
   Domains<NWORDS> domains(m.pattern_size);
   if (!initialise_domains(m, domains)) {
@@ -657,10 +932,7 @@ int hpx_main(boost::program_options::variables_map & opts) {
     return hpx::finalize();
   }
 
-  Assignments assignments;
-  assignments.values.reserve(m.pattern_size);
-
-  SIPNode<NWORDS> root(domains, assignments);
+  SIPNode<NWORDS> root(domains, Assignments(m.pattern_size));
 
   auto sol = root;
 
@@ -670,6 +942,51 @@ int hpx_main(boost::program_options::variables_map & opts) {
   searchParameters.expectedObjective = true;
 
   auto skeleton = opts["skeleton"].as<std::string>();
+
+  // Enumerate every isomorphism rather than stopping at the first
+  if (opts.count("all-solutions")) {
+    if (opts.count("solution-file")) {
+      searchParameters.solutionFile = opts["solution-file"].as<std::string>();
+    }
+
+    std::vector<SIPNode<NWORDS> > sols;
+    if (skeleton == "seq") {
+      sols = YewPar::Skeletons::Seq<GenNode<NWORDS>,
+                                   YewPar::Skeletons::API::AllSolutions>
+          ::search(m, root, searchParameters);
+    } else if (skeleton == "depthbounded") {
+      searchParameters.spawnDepth = opts["spawn-depth"].as<std::uint64_t>();
+      sols = YewPar::Skeletons::DepthBounded<GenNode<NWORDS>,
+                                            YewPar::Skeletons::API::AllSolutions>
+          ::search(m, root, searchParameters);
+    } else if (skeleton == "stacksteal") {
+      searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
+      sols = YewPar::Skeletons::StackStealing<GenNode<NWORDS>,
+                                             YewPar::Skeletons::API::AllSolutions>
+          ::search(m, root, searchParameters);
+    } else if (skeleton == "budget") {
+      searchParameters.backtrackBudget = opts["backtrack-budget"].as<std::uint64_t>();
+      sols = YewPar::Skeletons::Budget<GenNode<NWORDS>,
+                                      YewPar::Skeletons::API::AllSolutions>
+          ::search(m, root, searchParameters);
+    } else {
+      std::cerr << "Invalid skeleton type for all solutions\n";
+      return hpx::finalize();
+    }
+
+    auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now() - start_time);
+
+    if (searchParameters.solutionFile.empty()) {
+      hpx::cout << "Solutions found: " << sols.size() << hpx::endl;
+    } else {
+      hpx::cout << "Solutions written to: " << searchParameters.solutionFile << ".<locality>" << hpx::endl;
+    }
+    hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
+
+    return hpx::finalize();
+  }
+
   if (skeleton == "seq") {
     sol = YewPar::Skeletons::Seq<GenNode<NWORDS>,
                                 YewPar::Skeletons::API::Decision,
@@ -720,15 +1037,24 @@ int hpx_main(boost::program_options::variables_map & opts) {
           ::search(m, root, searchParameters);
 
     }
+  } else if (skeleton == "restarts") {
+    searchParameters.restartBase = opts["restart-base"].as<std::uint64_t>();
+    searchParameters.nogoodLimit = opts["nogood-limit"].as<std::uint64_t>();
+    sol = YewPar::Skeletons::Restarts<GenNode<NWORDS>,
+                                     YewPar::Skeletons::API::Decision,
+                                     YewPar::Skeletons::API::Nogoods<SIPNogoods<NWORDS> >,
+                                     YewPar::Skeletons::API::MoreVerbose>
+        ::search(m, root, searchParameters);
   } else {
     std::cerr << "Invalid skeleton type\n";
     return hpx::finalize();
   }
 
   std::map<int, int> res_isomorphism;
-  for (auto & a : sol.assignments.values) {
-    res_isomorphism.emplace(m.pattern_permutation.at(get<0>(a).variable),
-                            m.target_permutation.at(get<0>(a).value));
+  for (unsigned v = 0 ; v < sol.assignments.values.size() ; ++v) {
+    if (sol.assignments.assigned(v))
+      res_isomorphism.emplace(m.pattern_permutation.at(v),
+                              m.target_permutation.at(sol.assignments.values[v]));
   }
 
   auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
@@ -754,7 +1080,7 @@ int main (int argc, char* argv[]) {
   desc_commandline.add_options()
       ( "skeleton",
         boost::program_options::value<std::string>()->default_value("seq"),
-        "Which skeleton to use: seq, depthbound, stacksteal, budget, or ordered"
+        "Which skeleton to use: seq, depthbound, stacksteal, budget, ordered or restarts"
       )
       ( "spawn-depth,d",
         boost::program_options::value<std::uint64_t>()->default_value(0),
@@ -768,7 +1094,19 @@ int main (int argc, char* argv[]) {
        boost::program_options::value<std::string>()->default_value("depthpool"),
        "Pool type for depthbounded skeleton")
       ("discrepancyOrder", "Use discrepancy order for the ordered skeleton")
+      ( "restart-base",
+        boost::program_options::value<std::uint64_t>()->default_value(100),
+        "Dead ends per unit of the Luby restart sequence for the restarts skeleton (0 never restarts)"
+      )
+      ( "nogood-limit",
+        boost::program_options::value<std::uint64_t>()->default_value(10000),
+        "Nogoods kept per locality by the restarts skeleton (0 learns none)"
+      )
       ("chunked", "Use chunking with stack stealing")
+      ("all-solutions", "Find every isomorphism instead of the first")
+      ("solution-file",
+       boost::program_options::value<std::string>(),
+       "With --all-solutions, spill solutions to this file (one per locality)")
       ("pattern",
       boost::program_options::value<std::string>()->required(),
       "Specify the pattern file (LAD format)"
@@ -776,6 +1114,10 @@ int main (int argc, char* argv[]) {
       ("target",
       boost::program_options::value<std::string>()->required(),
       "Specify the target file (LAD format)"
+      )
+      ("model-cache",
+      boost::program_options::value<std::string>(),
+      "Keep the preprocessed model in this file and load it on later runs instead of parsing the inputs again"
       );
 
   YewPar::registerPerformanceCounters();
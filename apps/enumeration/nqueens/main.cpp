@@ -69,6 +69,26 @@ struct NodeGen : YewPar::NodeGenerator<Node, Empty> {
   }
 };
 
+// Count complete boards (every column filled) as we enumerate the tree
+struct SolutionCount {
+  std::uint64_t solutions = 0;
+
+  void accumulate(const Node & n) {
+    if (n.cols == n.all) {
+      ++solutions;
+    }
+  }
+
+  void combine(const SolutionCount & other) {
+    solutions += other.solutions;
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & solutions;
+  }
+};
+
 int hpx_main(boost::program_options::variables_map & opts) {
   auto spawnDepth = opts["spawn-depth"].as<unsigned>();
   auto size = opts["size"].as<unsigned>();
@@ -79,34 +99,30 @@ int hpx_main(boost::program_options::variables_map & opts) {
 
   auto start_time = std::chrono::steady_clock::now();
 
-  std::vector<std::uint64_t> counts;
+  SolutionCount res;
   if (skeleton == "seq") {
     YewPar::Skeletons::API::Params<> searchParameters;
-    counts = YewPar::Skeletons::Seq<NodeGen,
-                                    YewPar::Skeletons::API::CountNodes,
-                                    YewPar::Skeletons::API::DepthLimited>
-             ::search(Empty(), root, searchParameters);
+    res = YewPar::Skeletons::Seq<NodeGen,
+                                 YewPar::Skeletons::API::Enumeration<SolutionCount> >
+          ::search(Empty(), root, searchParameters);
   } else if (skeleton == "depthbounded") {
     YewPar::Skeletons::API::Params<> searchParameters;
     searchParameters.spawnDepth = spawnDepth;
-    counts = YewPar::Skeletons::DepthBounded<NodeGen,
-                                            YewPar::Skeletons::API::CountNodes,
-                                            YewPar::Skeletons::API::DepthLimited>
-             ::search(Empty(), root, searchParameters);
+    res = YewPar::Skeletons::DepthBounded<NodeGen,
+                                          YewPar::Skeletons::API::Enumeration<SolutionCount> >
+          ::search(Empty(), root, searchParameters);
   } else if (skeleton == "stacksteal"){
     YewPar::Skeletons::API::Params<> searchParameters;
     searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
-    counts = YewPar::Skeletons::StackStealing<NodeGen,
-                                              YewPar::Skeletons::API::CountNodes,
-                                              YewPar::Skeletons::API::DepthLimited>
-             ::search(Empty(), root, searchParameters);
+    res = YewPar::Skeletons::StackStealing<NodeGen,
+                                           YewPar::Skeletons::API::Enumeration<SolutionCount> >
+          ::search(Empty(), root, searchParameters);
   } else if (skeleton == "budget"){
     YewPar::Skeletons::API::Params<> searchParameters;
     searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
-    counts = YewPar::Skeletons::Budget<NodeGen,
-                                       YewPar::Skeletons::API::CountNodes,
-                                       YewPar::Skeletons::API::DepthLimited>
-        ::search(Empty(), root, searchParameters);
+    res = YewPar::Skeletons::Budget<NodeGen,
+                                    YewPar::Skeletons::API::Enumeration<SolutionCount> >
+          ::search(Empty(), root, searchParameters);
   } else {
     hpx::cout << "Invalid skeleton type: " << skeleton << hpx::endl;
     return hpx::finalize();
@@ -115,16 +131,7 @@ int hpx_main(boost::program_options::variables_map & opts) {
   auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
                       (std::chrono::steady_clock::now() - start_time);
 
-  auto res = 0;
-  for (auto i = 0; i <= counts.size(); ++i) {
-    if (counts[i] == 0) {
-        break;
-    }
-    res = counts[i];
-    // hpx::cout << i << ": " << counts[i] << hpx::endl;
-  }
-  hpx::cout << "Warning results are incorrect for boards with 0 solutions (due to how nodes are currently counted)" << hpx::endl;
-  hpx::cout << "Solution for n = " << size <<  ": " << res << hpx::endl;
+  hpx::cout << "Solution for n = " << size <<  ": " << res.solutions << hpx::endl;
 
   hpx::cout << "=====" << hpx::endl;
   hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
@@ -58,6 +58,12 @@ int hpx_main(boost::program_options::variables_map & opts) {
     YewPar::Skeletons::API::Params<> searchParameters;
     searchParameters.maxDepth   = maxDepth;
     searchParameters.spawnDepth = spawnDepth;
+    searchParameters.nodeLimit  = opts["node-limit"].as<std::uint64_t>();
+    if (opts.count("checkpoint-file")) {
+      searchParameters.checkpointFile = opts["checkpoint-file"].as<std::string>();
+      searchParameters.checkpointInterval = opts["checkpoint-interval"].as<unsigned>();
+      searchParameters.restart = static_cast<bool>(opts.count("restart"));
+    }
     counts = YewPar::Skeletons::DepthBounded<NodeGen,
                                             YewPar::Skeletons::API::CountNodes,
                                             YewPar::Skeletons::API::DepthLimited>
@@ -121,7 +127,20 @@ int main(int argc, char* argv[]) {
       boost::program_options::value<bool>()->default_value(false),
       "Enable verbose output"
     )
-    ("chunked", "Use chunking with stack stealing");
+    ("chunked", "Use chunking with stack stealing")
+    ( "node-limit",
+      boost::program_options::value<std::uint64_t>()->default_value(0),
+      "Stop after processing this many nodes (depthbounded only, 0 = no limit)"
+    )
+    ( "checkpoint-file",
+      boost::program_options::value<std::string>(),
+      "Periodically checkpoint the search to this file (depthbounded only)"
+    )
+    ( "checkpoint-interval",
+      boost::program_options::value<unsigned>()->default_value(300),
+      "Seconds between checkpoints"
+    )
+    ("restart", "Resume the search from the checkpoint file");
 
   YewPar::registerPerformanceCounters();
 
@@ -0,0 +1,170 @@
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/iostreams.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "YewPar.hpp"
+#include "skeletons/Seq.hpp"
+#include "skeletons/DepthBounded.hpp"
+#include "skeletons/StackStealing.hpp"
+#include "skeletons/Budget.hpp"
+#include "skeletons/Ordered.hpp"
+
+#include "synthetic.hpp"
+
+int upperBound(const Synthetic::Params & space, const Synthetic::Node & n) {
+  return Synthetic::upperBound(space, n);
+}
+
+typedef func<decltype(&upperBound), &upperBound> upperBound_func;
+
+// Every skeleton takes the same search type arguments, only the Params differ
+template <typename ...Args>
+auto search(const std::string & skeleton,
+            const Synthetic::Params & space,
+            const Synthetic::Node & root,
+            YewPar::Skeletons::API::Params<> searchParameters,
+            boost::program_options::variables_map & opts) {
+  if (skeleton == "depthbounded") {
+    searchParameters.spawnDepth = opts["spawn-depth"].as<unsigned>();
+    return YewPar::Skeletons::DepthBounded<Synthetic::NodeGen, Args...>::search(space, root, searchParameters);
+  } else if (skeleton == "stacksteal") {
+    searchParameters.stealAll = static_cast<bool>(opts.count("chunked"));
+    return YewPar::Skeletons::StackStealing<Synthetic::NodeGen, Args...>::search(space, root, searchParameters);
+  } else if (skeleton == "budget") {
+    searchParameters.backtrackBudget = opts["backtrack-budget"].as<unsigned>();
+    return YewPar::Skeletons::Budget<Synthetic::NodeGen, Args...>::search(space, root, searchParameters);
+  } else if (skeleton == "ordered") {
+    searchParameters.spawnDepth = opts["spawn-depth"].as<unsigned>();
+    return YewPar::Skeletons::Ordered<Synthetic::NodeGen, Args...>::search(space, root, searchParameters);
+  }
+  return YewPar::Skeletons::Seq<Synthetic::NodeGen, Args...>::search(space, root, searchParameters);
+}
+
+int hpx_main(boost::program_options::variables_map & opts) {
+  auto skeleton = opts["skeleton"].as<std::string>();
+  if (skeleton != "seq" && skeleton != "depthbounded" && skeleton != "stacksteal" &&
+      skeleton != "budget" && skeleton != "ordered") {
+    hpx::cout << "Invalid skeleton type: " << skeleton << hpx::endl;
+    return hpx::finalize();
+  }
+
+  Synthetic::Params space;
+  if (!Synthetic::parseShape(opts["shape"].as<std::string>(), space.shape)) {
+    hpx::cout << "Invalid tree shape: " << opts["shape"].as<std::string>() << hpx::endl;
+    return hpx::finalize();
+  }
+  space.branching        = opts["branching"].as<double>();
+  space.nonLeafProb      = opts["non-leaf-prob"].as<double>();
+  space.nonLeafBranching = opts["non-leaf-branching"].as<unsigned>();
+  space.alpha            = opts["alpha"].as<double>();
+  space.maxDepth         = opts["max-depth"].as<unsigned>();
+  space.maxChildren      = opts["max-children"].as<unsigned>();
+  space.workNs           = opts["work-ns"].as<std::uint64_t>();
+  space.payloadBytes     = opts["payload-bytes"].as<std::uint32_t>();
+  space.seed             = opts["seed"].as<std::uint64_t>();
+  space.maxGain          = opts["max-gain"].as<int>();
+
+  auto root = Synthetic::makeRoot(space);
+
+  YewPar::Skeletons::API::Params<> searchParameters;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  if (opts.count("bnb")) {
+    auto sol = search<YewPar::Skeletons::API::Optimisation,
+                      YewPar::Skeletons::API::BoundFunction<upperBound_func> >(
+                          skeleton, space, root, searchParameters, opts);
+
+    auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
+                        (std::chrono::steady_clock::now() - start_time);
+
+    hpx::cout << "Best Objective: " << sol.getObj() << hpx::endl;
+    hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
+  } else {
+    auto counts = search<YewPar::Skeletons::API::CountNodes>(
+        skeleton, space, root, searchParameters, opts);
+
+    auto overall_time = std::chrono::duration_cast<std::chrono::milliseconds>
+                        (std::chrono::steady_clock::now() - start_time);
+
+    hpx::cout << "Total Nodes: " << std::accumulate(counts.begin(), counts.end(), std::uint64_t(0)) << hpx::endl;
+    hpx::cout << "=====" << hpx::endl;
+    hpx::cout << "cpu = " << overall_time.count() << hpx::endl;
+  }
+
+  return hpx::finalize();
+}
+
+int main(int argc, char* argv[]) {
+  boost::program_options::options_description
+    desc_commandline("Usage: " HPX_APPLICATION_STRING " [options]");
+
+  desc_commandline.add_options()
+    ( "skeleton",
+      boost::program_options::value<std::string>()->default_value("seq"),
+      "Which skeleton to use: seq, depthbounded, stacksteal, budget, or ordered"
+    )
+    ( "spawn-depth,d",
+      boost::program_options::value<unsigned>()->default_value(0),
+      "Depth in the tree to spawn until (for parallel skeletons only)"
+    )
+    ( "backtrack-budget,b",
+      boost::program_options::value<unsigned>()->default_value(500),
+      "Number of backtracks before spawning work"
+    )
+    ("chunked", "Use chunking with stack stealing")
+    ("bnb", "Branch and bound for the largest synthetic objective instead of counting nodes")
+    // Tree options
+    ( "shape",
+      boost::program_options::value<std::string>()->default_value("fixed"),
+      "Tree shape: fixed, geometric, binomial or fattail"
+    )
+    ( "branching",
+      boost::program_options::value<double>()->default_value(2),
+      "Children per node (fixed), mean children (geometric), root children (binomial) or scale (fattail)"
+    )
+    ( "non-leaf-prob",
+      boost::program_options::value<double>()->default_value(0.25),
+      "Binomial: probability that a node has children"
+    )
+    ( "non-leaf-branching",
+      boost::program_options::value<unsigned>()->default_value(4),
+      "Binomial: children of a non-leaf node"
+    )
+    ( "alpha",
+      boost::program_options::value<double>()->default_value(1.5),
+      "Fattail: tail index, smaller is heavier"
+    )
+    ( "max-depth",
+      boost::program_options::value<unsigned>()->default_value(10),
+      "Nodes at this depth have no children (at most 5000)"
+    )
+    ( "max-children",
+      boost::program_options::value<unsigned>()->default_value(1000),
+      "Upper limit on the children of a single node"
+    )
+    ( "work-ns",
+      boost::program_options::value<std::uint64_t>()->default_value(0),
+      "Busy work per node in nanoseconds"
+    )
+    ( "payload-bytes",
+      boost::program_options::value<std::uint32_t>()->default_value(0),
+      "Size of the payload carried by every node"
+    )
+    ( "seed",
+      boost::program_options::value<std::uint64_t>()->default_value(0),
+      "Random seed for the tree"
+    )
+    ( "max-gain",
+      boost::program_options::value<int>()->default_value(100),
+      "BnB: largest objective gain per level"
+    );
+
+  YewPar::registerPerformanceCounters();
+
+  return hpx::init(desc_commandline, argc, argv);
+}
@@ -0,0 +1,179 @@
+#ifndef YEWPAR_SYNTHETIC_HPP
+#define YEWPAR_SYNTHETIC_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <hpx/runtime/serialization/vector.hpp>
+
+#include "util/NodeGenerator.hpp"
+
+// Synthetic search trees for measuring skeleton overheads. Unlike UTS the
+// per-node cost is not fixed by a hash function: each node costs a
+// configurable amount of busy work, carries a configurable payload (to stress
+// serialisation when stolen) and can have a synthetic objective/bound for
+// branch and bound. The tree only depends on the parameters and the seed so
+// every skeleton sees the same tree.
+namespace Synthetic {
+
+enum class Shape {
+  Fixed,     // every node has `branching` children
+  Geometric, // geometrically distributed children with mean `branching`
+  Binomial,  // `nonLeafBranching` children with probability `nonLeafProb`
+  FatTail    // Lomax (Pareto II) distributed children, scale `branching`
+};
+
+inline bool parseShape(const std::string & s, Shape & shape) {
+  if (s == "fixed")          { shape = Shape::Fixed; }
+  else if (s == "geometric") { shape = Shape::Geometric; }
+  else if (s == "binomial")  { shape = Shape::Binomial; }
+  else if (s == "fattail")   { shape = Shape::FatTail; }
+  else { return false; }
+  return true;
+}
+
+// Used as the search space
+struct Params {
+  Shape shape = Shape::Fixed;
+  double branching = 2;
+  double nonLeafProb = 0.25;
+  unsigned nonLeafBranching = 4;
+  double alpha = 1.5;
+  unsigned maxDepth = 10;
+  unsigned maxChildren = 1000;
+  std::uint64_t workNs = 0;
+  std::uint32_t payloadBytes = 0;
+  std::uint64_t seed = 0;
+  int maxGain = 100;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & shape;
+    ar & branching;
+    ar & nonLeafProb;
+    ar & nonLeafBranching;
+    ar & alpha;
+    ar & maxDepth;
+    ar & maxChildren;
+    ar & workNs;
+    ar & payloadBytes;
+    ar & seed;
+    ar & maxGain;
+  }
+};
+
+struct Node {
+  std::uint64_t seed;
+  unsigned depth;
+  // Sum of the gains on the path from the root
+  int obj;
+  std::vector<std::uint8_t> payload;
+
+  int getObj() const {
+    return obj;
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & seed;
+    ar & depth;
+    ar & obj;
+    ar & payload;
+  }
+};
+
+inline std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Uniform on [0, 1)
+inline double toUnit(std::uint64_t x) {
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline Node makeRoot(const Params & params) {
+  return {splitmix64(params.seed), 0, 0, std::vector<std::uint8_t>(params.payloadBytes)};
+}
+
+inline unsigned numChildren(const Params & params, const Node & n) {
+  if (n.depth >= params.maxDepth) {
+    return 0;
+  }
+
+  auto u = toUnit(splitmix64(n.seed));
+  double children = 0;
+  switch (params.shape) {
+    case Shape::Fixed:
+      children = params.branching;
+      break;
+    case Shape::Geometric: {
+      auto p = 1.0 / (1.0 + params.branching);
+      children = std::floor(std::log(1.0 - u) / std::log(1.0 - p));
+      break;
+    }
+    case Shape::Binomial:
+      if (n.depth == 0) {
+        children = params.branching;
+      } else {
+        children = u < params.nonLeafProb ? params.nonLeafBranching : 0;
+      }
+      break;
+    case Shape::FatTail:
+      children = std::floor(params.branching * (std::pow(1.0 - u, -1.0 / params.alpha) - 1.0));
+      break;
+  }
+  return static_cast<unsigned>(std::min<double>(children, params.maxChildren));
+}
+
+inline Node child(const Params & params, const Node & parent, unsigned i) {
+  auto seed = splitmix64(parent.seed + (i + 1) * 0x9E3779B97F4A7C15ULL);
+  auto gain = params.maxGain > 0 ? static_cast<int>(splitmix64(seed ^ 0x5851F42D4C957F2DULL) % (params.maxGain + 1)) : 0;
+  return {seed, parent.depth + 1, parent.obj + gain,
+          std::vector<std::uint8_t>(params.payloadBytes, static_cast<std::uint8_t>(seed))};
+}
+
+// Admissible: no descendant can gain more than maxGain per level
+inline int upperBound(const Params & params, const Node & n) {
+  return n.obj + static_cast<int>(params.maxDepth - n.depth) * params.maxGain;
+}
+
+inline void busyWork(const std::uint64_t ns) {
+  if (ns == 0) {
+    return;
+  }
+  auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+  while (std::chrono::steady_clock::now() < end) {}
+}
+
+// The busy work is charged once per node when its children are generated
+struct NodeGen : YewPar::NodeGenerator<Node, Params> {
+  std::reference_wrapper<const Params> params;
+  Node parent;
+  unsigned i = 0;
+
+  NodeGen(const Params & params, const Node & parent) : params(std::cref(params)), parent(parent) {
+    busyWork(params.workNs);
+    this->numChildren = Synthetic::numChildren(params, parent);
+  }
+
+  Node next() override {
+    return child(params.get(), parent, i++);
+  }
+
+  Node nth(unsigned n) {
+    i = n + 1;
+    return child(params.get(), parent, n);
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "workstealing/DepthPool.hpp"
+#include "workstealing/Workqueue.hpp"
+#include "workstealing/policies/SearchManager.hpp"
+#include "util/DistSetOnceFlag.hpp"
+#include "util/ShardedCounter.hpp"
+#include "util/func.hpp"
+
+// Microbenchmarks for the runtime pieces the skeletons are built from. Each
+// benchmark runs the same operation on 1..N HPX threads at once on a single
+// locality and reports the time per operation and the total throughput.
+
+// Tasks as the skeletons create them: an action bound to its arguments
+void noopTask(hpx::naming::id_type) {}
+HPX_PLAIN_ACTION(noopTask, noopTask_act)
+
+void completeTask(hpx::naming::id_type donePromise) {
+  hpx::async<hpx::lcos::base_lco_with_value<void>::set_value_action>(donePromise, true);
+}
+HPX_PLAIN_ACTION(completeTask, completeTask_act)
+
+void stolenTask(int, int, hpx::naming::id_type) {}
+typedef func<decltype(&stolenTask), &stolenTask> stolenTask_func;
+
+using Task = hpx::util::function<void(hpx::naming::id_type)>;
+using SearchManagerComp = Workstealing::Policies::SearchManager::SearchManagerComp<int, stolenTask_func>;
+
+struct Result {
+  std::string name;
+  unsigned contenders;
+  std::uint64_t ops;
+  double seconds;
+};
+
+// Runs body(i, iterations) on `contenders` HPX threads and times from when
+// they are all running until the last one finishes. body returns the number
+// of operations it performed.
+Result run(const std::string & name,
+           const unsigned contenders,
+           const std::uint64_t iterations,
+           std::function<std::uint64_t(unsigned, std::uint64_t)> body) {
+  std::atomic<unsigned> ready {0};
+  std::atomic<bool> go {false};
+
+  std::vector<hpx::future<std::uint64_t> > futs;
+  for (auto i = 0u; i < contenders; ++i) {
+    futs.push_back(hpx::async([&, i]() {
+          ++ready;
+          while (!go) {
+            hpx::this_thread::yield();
+          }
+          return body(i, iterations);
+        }));
+  }
+
+  while (ready < contenders) {
+    hpx::this_thread::yield();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  go = true;
+
+  std::uint64_t ops = 0;
+  for (auto & f : futs) {
+    ops += f.get();
+  }
+
+  auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return {name, contenders, ops, secs};
+}
+
+std::vector<Result> runAll(const unsigned maxContenders,
+                           const std::uint64_t iterations,
+                           const std::regex & filter) {
+  std::vector<Result> results;
+  auto here = hpx::find_here();
+
+  auto bench = [&](const std::string & name,
+                   std::function<std::uint64_t(unsigned, std::uint64_t)> body,
+                   std::function<void()> setup = nullptr,
+                   std::function<void()> teardown = nullptr) {
+    if (!std::regex_search(name, filter)) {
+      return;
+    }
+    for (auto n = 1u; n <= maxContenders; n *= 2) {
+      if (setup) {
+        setup();
+      }
+      auto r = run(name, n, iterations, body);
+      if (teardown) {
+        teardown();
+      }
+      hpx::cout << (boost::format("%-32s %3u threads %10.1f ns/op %12.0f ops/s\n")
+                    % r.name % r.contenders
+                    % (r.seconds * 1e9 * r.contenders / r.ops) % (r.ops / r.seconds))
+                << hpx::flush;
+      results.push_back(r);
+    }
+  };
+
+  // Counters (see util/ShardedCounter.hpp)
+  std::atomic<std::uint64_t> atomicCounter {0};
+  bench("counter_atomic", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        atomicCounter++;
+      }
+      return iters;
+    });
+
+  auto shardedCounter = std::make_unique<YewPar::util::ShardedCounter>();
+  bench("counter_sharded", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        (*shardedCounter)++;
+      }
+      return iters;
+    });
+
+  Task noop = hpx::util::bind(noopTask_act(), hpx::util::placeholders::_1);
+
+  // Workqueue (Workpool policy)
+  auto workqueue = hpx::new_<workstealing::Workqueue>(here).get();
+  bench("workqueue_addwork_getlocal", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::async<workstealing::Workqueue::addWork_action>(workqueue, noop).get();
+        hpx::async<workstealing::Workqueue::getLocal_action>(workqueue).get();
+      }
+      return iters;
+    });
+
+  bench("workqueue_addwork_steal", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::async<workstealing::Workqueue::addWork_action>(workqueue, noop).get();
+        hpx::async<workstealing::Workqueue::steal_action>(workqueue).get();
+      }
+      return iters;
+    });
+
+  // DepthPool (DepthPool policy)
+  auto depthpool = hpx::new_<workstealing::DepthPool>(here).get();
+  bench("depthpool_addwork_getlocal", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::async<workstealing::DepthPool::addWork_action>(depthpool, noop, i % 8).get();
+        hpx::async<workstealing::DepthPool::getLocal_action>(depthpool).get();
+      }
+      return iters;
+    });
+
+  bench("depthpool_addwork_steal", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::async<workstealing::DepthPool::addWork_action>(depthpool, noop, i % 8).get();
+        hpx::async<workstealing::DepthPool::steal_action>(depthpool).get();
+      }
+      return iters;
+    });
+
+  // Task creation as in DepthBounded::createTask: promise, bound task, push to
+  // the pool, then run tasks from the pool until our promise is set (another
+  // thread may have run our task)
+  bench("task_promise_roundtrip", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::lcos::promise<void> prom;
+        auto pfut = prom.get_future();
+        auto pid  = prom.get_id();
+
+        Task task = hpx::util::bind(completeTask_act(), pid);
+        hpx::async<workstealing::Workqueue::addWork_action>(workqueue, task).get();
+
+        while (!pfut.is_ready()) {
+          auto t = hpx::async<workstealing::Workqueue::getLocal_action>(workqueue).get();
+          if (t) {
+            t(here);
+          } else {
+            hpx::this_thread::yield();
+          }
+        }
+      }
+      return iters;
+    });
+
+  // SearchManager (StackStealing/Budget). With no registered threads getWork
+  // is a failed steal; otherwise a victim thread answers each request.
+  std::shared_ptr<SearchManagerComp> searchManager;
+  auto newSearchManager = [&]() { searchManager = std::make_shared<SearchManagerComp>(); };
+  bench("searchmanager_getwork_empty", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        searchManager->getWork();
+      }
+      return iters;
+    }, newSearchManager);
+
+  // The victim answers every steal request with a single task, in the same
+  // way as a StackStealing search thread
+  std::atomic<bool> stopVictim;
+  hpx::future<void> victim;
+  unsigned victimId;
+  auto startVictim = [&]() {
+    newSearchManager();
+    std::shared_ptr<SearchManagerComp::SharedState_t> stealRequest;
+    std::tie(stealRequest, victimId) = searchManager->registerThread();
+
+    stopVictim = false;
+    victim = hpx::async([&, stealRequest]() {
+        while (!stopVictim) {
+          if (std::get<0>(*stealRequest)) {
+            SearchManagerComp::Response_t res;
+            res.emplace_back(hpx::util::make_tuple(0, 1, here));
+            std::get<1>(*stealRequest).set(res);
+            std::get<0>(*stealRequest).store(false);
+          } else {
+            hpx::this_thread::yield();
+          }
+        }
+      });
+  };
+  auto stopVictimThread = [&]() {
+    stopVictim = true;
+    victim.get();
+    searchManager->unregisterThread(victimId);
+  };
+  bench("searchmanager_getwork_steal", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        searchManager->getWork();
+      }
+      return iters;
+    }, startVictim, stopVictimThread);
+
+  // DistSetOnceFlag (Ordered)
+  hpx::naming::id_type flag;
+  bench("distsetonceflag_set", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        hpx::async<YewPar::util::DistSetOnceFlag::set_value_action>(flag).get();
+      }
+      return iters;
+    }, [&]() { flag = hpx::new_<YewPar::util::DistSetOnceFlag>(here).get(); });
+
+  bench("distsetonceflag_new_set", [&](unsigned, std::uint64_t iters) {
+      for (std::uint64_t i = 0; i < iters; ++i) {
+        auto f = hpx::new_<YewPar::util::DistSetOnceFlag>(here).get();
+        hpx::async<YewPar::util::DistSetOnceFlag::set_value_action>(f).get();
+      }
+      return iters;
+    });
+
+  return results;
+}
+
+int hpx_main(boost::program_options::variables_map & opts) {
+  auto iterations = opts["iterations"].as<std::uint64_t>();
+  auto maxContenders = opts["max-threads"].as<unsigned>();
+  if (maxContenders == 0) {
+    maxContenders = hpx::get_os_thread_count();
+  }
+  std::regex filter(opts["filter"].as<std::string>());
+
+  auto results = runAll(maxContenders, iterations, filter);
+
+  if (opts.count("csv")) {
+    std::ofstream f(opts["csv"].as<std::string>());
+    f << "benchmark,threads,ops,seconds,ns_per_op,ops_per_sec\n";
+    for (const auto & r : results) {
+      f << r.name << "," << r.contenders << "," << r.ops << "," << r.seconds << ","
+        << (r.seconds * 1e9 * r.contenders / r.ops) << "," << (r.ops / r.seconds) << "\n";
+    }
+  }
+
+  return hpx::finalize();
+}
+
+int main(int argc, char* argv[]) {
+  boost::program_options::options_description
+    desc_commandline("Usage: " HPX_APPLICATION_STRING " [options]");
+
+  desc_commandline.add_options()
+    ( "iterations,i",
+      boost::program_options::value<std::uint64_t>()->default_value(100000),
+      "Operations per thread for each benchmark"
+    )
+    ( "max-threads,t",
+      boost::program_options::value<unsigned>()->default_value(0),
+      "Largest number of contending threads (default: all worker threads)"
+    )
+    ( "filter",
+      boost::program_options::value<std::string>()->default_value(""),
+      "Only run benchmarks whose name matches this regex"
+    )
+    ( "csv",
+      boost::program_options::value<std::string>(),
+      "Also write the results as CSV to this file"
+    );
+
+  return hpx::init(desc_commandline, argc, argv);
+}
@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""Benchmark driver for the YewPar applications.
+
+Runs every benchmark in a suite file over a sweep of skeleton x thread count x
+skeleton parameter (spawn depth, backtrack budget, chunking) and writes one
+row per configuration with the median runtime, nodes/sec and the
+speedup/efficiency over the sequential (or single threaded) run.
+
+Usage:
+  yewpar_bench.py --build-dir build --suite bench/suites/standard.json \
+                  --threads 1,2,4,8 --csv results.csv --json results.json
+"""
+
+import argparse
+import csv
+import fnmatch
+import itertools
+import json
+import os
+import random
+import re
+import statistics
+import subprocess
+import sys
+
+# Which parameter is swept for each skeleton, and the values used unless a
+# benchmark overrides them
+DEFAULT_SWEEP = {
+    "seq": {},
+    "depthbounded": {"spawn-depth": [1, 2]},
+    "ordered": {"spawn-depth": [1, 2]},
+    "budget": {"backtrack-budget": [100, 1000, 10000]},
+    "stacksteal": {"chunked": [False, True]},
+}
+
+RUNTIME_RE = re.compile(r"^cpu = (\d+)", re.MULTILINE)
+COUNTER_RE = re.compile(r"/nodes/processed,[^,]*,[^,]*,(\d+)")
+TOTAL_NODES_RE = re.compile(r"^Total Nodes: (\d+)", re.MULTILINE)
+
+FIELDS = ["benchmark", "app", "skeleton", "param", "value", "threads",
+          "repeats", "runtime_ms", "runtime_min_ms", "runtime_max_ms",
+          "nodes", "nodes_per_sec", "speedup", "efficiency", "ok"]
+
+
+def find_executable(build_dir, pattern):
+    for root, _, files in sorted(os.walk(build_dir)):
+        for f in sorted(files):
+            path = os.path.join(root, f)
+            if fnmatch.fnmatch(f, pattern) and os.access(path, os.X_OK) and not os.path.isdir(path):
+                return path
+    return None
+
+
+# Knapsack instances in the style of Pisinger's generator so the suite does
+# not need to ship data files. The expected profit is computed by dynamic
+# programming so the app can check its own answer.
+def generate_knapsack(out_dir, name, kind, items, value_range, seed):
+    rng = random.Random(seed)
+    ws, ps = [], []
+    for _ in range(items):
+        w = rng.randint(1, value_range)
+        if kind == "uncorrelated":
+            p = rng.randint(1, value_range)
+        elif kind == "weak":
+            p = max(1, w + rng.randint(-value_range // 10, value_range // 10))
+        elif kind == "strong":
+            p = w + value_range // 10
+        else:
+            raise ValueError("Unknown knapsack kind: " + kind)
+        ws.append(w)
+        ps.append(p)
+    capacity = sum(ws) // 2
+
+    best = [0] * (capacity + 1)
+    for w, p in zip(ws, ps):
+        for c in range(capacity, w - 1, -1):
+            best[c] = max(best[c], best[c - w] + p)
+
+    path = os.path.join(out_dir, name + ".kp")
+    with open(path, "w") as f:
+        f.write("{}\n{}\n".format(capacity, best[capacity]))
+        for p, w in zip(ps, ws):
+            f.write("{} {}\n".format(p, w))
+    return path
+
+
+def generate_instance(out_dir, name, spec):
+    if spec["type"] == "knapsack":
+        return generate_knapsack(out_dir, name, spec["kind"], spec["items"],
+                                 spec.get("range", 1000), spec.get("seed", 0))
+    raise ValueError("Unknown generator: " + spec["type"])
+
+
+def expand_args(args, subst):
+    return [a.format(**subst) for a in args]
+
+
+def configurations(bench, threads):
+    sweep = dict(DEFAULT_SWEEP)
+    sweep.update(bench.get("sweep", {}))
+    for skel in bench["skeletons"]:
+        params = sweep.get(skel, {})
+        if skel == "seq":
+            yield skel, "", None, 1
+            continue
+        if not params:
+            for t in threads:
+                yield skel, "", None, t
+            continue
+        for param, values in sorted(params.items()):
+            for value, t in itertools.product(values, threads):
+                yield skel, param, value, t
+
+
+def skeleton_args(skel, param, value):
+    args = ["--skeleton", skel]
+    if param == "chunked":
+        if value:
+            args.append("--chunked")
+    elif param:
+        args += ["--" + param, str(value)]
+    return args
+
+
+def run_once(cmd, timeout, verbose):
+    if verbose:
+        print("  $ " + " ".join(cmd), file=sys.stderr)
+    try:
+        res = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                             universal_newlines=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None, ""
+    return res.returncode, res.stdout
+
+
+def parse_output(out):
+    m = RUNTIME_RE.search(out)
+    runtime = int(m.group(1)) if m else None
+
+    counts = [int(n) for n in COUNTER_RE.findall(out)]
+    nodes = sum(counts) if counts and sum(counts) > 0 else None
+    if nodes is None:
+        m = TOTAL_NODES_RE.search(out)
+        nodes = int(m.group(1)) if m else None
+    return runtime, nodes
+
+
+def run_config(exe, args, skel, param, value, threads, expect, opts):
+    cmd = [exe] + args + skeleton_args(skel, param, value) + [
+        "--hpx:threads", str(threads),
+        "--hpx:print-counter=/yewpar/nodes/processed"]
+
+    runtimes, nodes, ok = [], None, True
+    for _ in range(opts.repeats):
+        code, out = run_once(cmd, opts.timeout, opts.verbose)
+        runtime, n = parse_output(out)
+        if code != 0 or runtime is None:
+            ok = False
+            break
+        if expect and not re.search(expect, out):
+            ok = False
+        runtimes.append(runtime)
+        nodes = n if n is not None else nodes
+    return runtimes, nodes, ok
+
+
+# Report configurations that got slower than a previous --json result
+def compare(rows, baseline_file, tolerance):
+    with open(baseline_file) as f:
+        old = {(r["benchmark"], r["skeleton"], r["param"], str(r["value"]), r["threads"]): r
+               for r in json.load(f)}
+
+    regressions = 0
+    for r in rows:
+        o = old.get((r["benchmark"], r["skeleton"], r["param"], str(r["value"]), r["threads"]))
+        if o is None or r["runtime_ms"] == "" or o["runtime_ms"] == "":
+            continue
+        change = (r["runtime_ms"] - o["runtime_ms"]) / max(o["runtime_ms"], 1)
+        if change > tolerance:
+            regressions += 1
+            print("REGRESSION {} {} {}={} {}T: {} ms -> {} ms ({:+.1%})".format(
+                r["benchmark"], r["skeleton"], r["param"], r["value"], r["threads"],
+                o["runtime_ms"], r["runtime_ms"], change), file=sys.stderr)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build-dir", required=True, help="CMake build directory holding the apps")
+    parser.add_argument("--suite", required=True, help="Suite description (JSON)")
+    parser.add_argument("--size", default="quick", choices=["quick", "full"],
+                        help="Run only the quick benchmarks, or everything")
+    parser.add_argument("--threads", default="1,2,4", help="Comma separated thread counts")
+    parser.add_argument("--repeats", type=int, default=3, help="Runs per configuration (median is reported)")
+    parser.add_argument("--timeout", type=int, default=3600, help="Seconds before a run is abandoned")
+    parser.add_argument("--filter", default="", help="Only run benchmarks whose name matches this regex")
+    parser.add_argument("--test-data-dir", default="", help="YewPar test/ directory")
+    parser.add_argument("--data-dir", default="", help="Directory holding the larger instances (e.g. DIMACS graphs)")
+    parser.add_argument("--work-dir", default="", help="Where generated instances are written")
+    parser.add_argument("--csv", default="", help="Write results as CSV")
+    parser.add_argument("--json", default="", help="Write results as JSON")
+    parser.add_argument("--compare", default="", help="Flag runs slower than in this earlier --json result")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="Fractional slowdown allowed by --compare")
+    parser.add_argument("--verbose", action="store_true")
+    opts = parser.parse_args()
+
+    with open(opts.suite) as f:
+        suite = json.load(f)
+
+    threads = [int(t) for t in opts.threads.split(",")]
+    work_dir = opts.work_dir or os.path.join(opts.build_dir, "bench", "instances")
+    os.makedirs(work_dir, exist_ok=True)
+
+    rows = []
+    for bench in suite["benchmarks"]:
+        name = bench["name"]
+        if opts.size == "quick" and bench.get("size", "quick") != "quick":
+            continue
+        if opts.filter and not re.search(opts.filter, name):
+            continue
+
+        exe = find_executable(opts.build_dir, bench["app"])
+        if exe is None:
+            print("Skipping {}: {} not built".format(name, bench["app"]), file=sys.stderr)
+            continue
+
+        # Instances are either files ({test_data}, {data}) or generated
+        subst = {"test_data": opts.test_data_dir, "data": opts.data_dir}
+        if "generate" in bench:
+            subst["input"] = generate_instance(work_dir, name, bench["generate"])
+        elif "input" in bench:
+            subst["input"] = bench["input"].format(**subst)
+            if not os.path.exists(subst["input"]):
+                print("Skipping {}: {} not found".format(name, subst["input"]), file=sys.stderr)
+                continue
+        args = expand_args(bench.get("args", []), subst)
+
+        print("Running " + name, file=sys.stderr)
+        results = []
+        for skel, param, value, t in configurations(bench, threads):
+            runtimes, nodes, ok = run_config(exe, args, skel, param, value, t, bench.get("expect", ""), opts)
+            results.append((skel, param, value, t, runtimes, nodes, ok))
+
+        # Speedups are relative to the sequential skeleton where it was run,
+        # otherwise to the same configuration on a single thread
+        seq = [r for r in results if r[0] == "seq" and r[4]]
+        for skel, param, value, t, runtimes, nodes, ok in results:
+            row = dict.fromkeys(FIELDS, "")
+            row.update({"benchmark": name, "app": bench["app"], "skeleton": skel,
+                        "param": param, "value": "" if value is None else value,
+                        "threads": t, "repeats": len(runtimes), "ok": ok})
+            if runtimes:
+                median = statistics.median(runtimes)
+                row.update({"runtime_ms": median, "runtime_min_ms": min(runtimes),
+                            "runtime_max_ms": max(runtimes)})
+                if nodes is not None:
+                    row["nodes"] = nodes
+                    row["nodes_per_sec"] = round(nodes / max(median, 1) * 1000)
+
+                base = seq[0] if seq else next(
+                    (r for r in results if r[:3] == (skel, param, value) and r[3] == 1 and r[4]), None)
+                if base is not None:
+                    speedup = statistics.median(base[4]) / max(median, 1)
+                    row["speedup"] = round(speedup, 3)
+                    row["efficiency"] = round(speedup / t, 3)
+            rows.append(row)
+            print("  {:<12} {:<16} {:>6} {:>3}T {:>10} ms {}".format(
+                skel, param, str(row["value"]), t, row["runtime_ms"], "" if ok else "FAILED"),
+                  file=sys.stderr)
+
+    if opts.csv:
+        with open(opts.csv, "w", newline="") as f:
+            w = csv.DictWriter(f, fieldnames=FIELDS)
+            w.writeheader()
+            w.writerows(rows)
+    if opts.json:
+        with open(opts.json, "w") as f:
+            json.dump(rows, f, indent=1)
+    if not opts.csv and not opts.json:
+        w = csv.DictWriter(sys.stdout, fieldnames=FIELDS)
+        w.writeheader()
+        w.writerows(rows)
+
+    failed = not all(r["ok"] for r in rows)
+    if opts.compare and compare(rows, opts.compare, opts.tolerance) > 0:
+        failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
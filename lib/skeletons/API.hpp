@@ -1,6 +1,9 @@
 #ifndef SKELETONS_API_HPP
 #define SKELETONS_API_HPP
 
+#include <cstdint>
+#include <string>
+
 #include <boost/parameter.hpp>
 #include <boost/serialization/access.hpp>
 
@@ -21,6 +24,30 @@ namespace API {
 DEF_PRESENT_PARAMETER(CountNodes, CountNodes_)
 DEF_PRESENT_PARAMETER(Optimisation, Optimisation_)
 DEF_PRESENT_PARAMETER(Decision, Decision_)
+// Collect every node with getObj() == expectedObjective (solutions are not
+// expanded further). Returns a std::vector<Node>, see Params::solutionFile
+DEF_PRESENT_PARAMETER(AllSolutions, AllSolutions_)
+// Keep the Params::topK best nodes, using the k-th best as the pruning bound.
+// Returns a std::vector<Node>, best first
+DEF_PRESENT_PARAMETER(TopK, TopK_)
+
+// Enumeration: fold a user supplied monoid over every node of the tree (the
+// root and every child that isn't pruned). The type given must be default
+// constructible (the identity) and provide:
+//   void accumulate(const Node &);  // map a node and combine it in
+//   void combine(const Enum &);     // associative combine
+//   void serialize(Archive &, const unsigned int);
+// The search returns the combined value.
+BOOST_PARAMETER_TEMPLATE_KEYWORD(Enumeration)
+
+// Placeholder when no Enumeration is requested
+struct NoEnumeration {
+  template <typename Node>
+  void accumulate(const Node &) {}
+  void combine(const NoEnumeration &) {}
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {}
+};
 
 // Search Shape changers
 DEF_PRESENT_PARAMETER(DepthLimited, DepthLimited_)
@@ -39,6 +66,43 @@ BOOST_PARAMETER_TEMPLATE_KEYWORD(DepthBoundedPoolPolicy)
 // Ordered Discrpancy search toggle
 DEF_PRESENT_PARAMETER(DiscrepancySearch, DiscrepancySearch_)
 
+// Anytime search: called on the master locality for every improved incumbent
+// with the time since the search started.
+// Signature: void(const Node &, Bound, std::chrono::milliseconds)
+BOOST_PARAMETER_TEMPLATE_KEYWORD(IncumbentCallback)
+
+// Warm start (Optimisation only): a heuristic run on every worker of every
+// locality for Params::warmStartTime ms before the tree search. The best node
+// it finds seeds the incumbent and initial bound. It is called repeatedly
+// with a different seed each time, so should be a randomised construction
+// (plus local search) rather than loop itself. The node need only be valid as
+// an incumbent, it is never expanded.
+// Signature: Node(const Space &, const Node & root, std::uint64_t seed)
+BOOST_PARAMETER_TEMPLATE_KEYWORD(WarmStart)
+
+// Nogood learning for the Restarts skeleton (Decision only). Nodes record the
+// decision that created them:
+//   typedef ... Decision;  // serialisable
+//   Decision decision() const;
+// A nogood is a std::vector<Decision> that can't all hold in a solution. The
+// type given holds the nogoods a worker prunes with (so can index them as it
+// likes) and must provide:
+//   Nogoods(const Space &);
+//   void add(const std::vector<Decision> &);
+//   bool propagate(const Space &, Node &) const;  // false if now a dead end
+// Nogoods are only learned with this set.
+BOOST_PARAMETER_TEMPLATE_KEYWORD(Nogoods)
+
+// Placeholder when no Nogoods are requested
+struct NoNogoods {
+  template <typename Space>
+  NoNogoods(const Space &) {}
+  template <typename Nogood>
+  void add(const Nogood &) {}
+  template <typename Space, typename Node>
+  bool propagate(const Space &, Node &) const { return true; }
+};
+
 // Verbose output
 BOOST_PARAMETER_TEMPLATE_KEYWORD(Verbose_)
 // Basic Info
@@ -63,9 +127,18 @@ struct Params {
   // For B&B
   Obj initialBound = false;
 
+  // Time slice in milliseconds for the WarmStart heuristic, 0 disables it
+  std::uint64_t warmStartTime = 0;
+
   // Depth Spawns
   unsigned spawnDepth = 1;
 
+  // Restarts
+  // Dead ends allowed per unit of the Luby sequence before a worker restarts
+  std::uint64_t restartBase = 100;
+  // Nogoods kept in each locality's store, the oldest are dropped first
+  std::uint64_t nogoodLimit = 10000;
+
   // Stack Steals
   // Should we steal all remaining nodes at the highest depth or just one?
   bool stealAll = false;
@@ -74,15 +147,69 @@ struct Params {
   // FIXME: How to determine a good value for this?
   unsigned backtrackBudget = 200;
 
+  // Anytime search: stop early and return the best solution found so far once
+  // any of these limits is reached. 0 (or a negative gap) disables a limit.
+  // Wall clock time limit in milliseconds
+  std::uint64_t timeLimit = 0;
+
+  // Total number of nodes processed over all localities
+  std::uint64_t nodeLimit = 0;
+
+  // Optimisation only: stop once the incumbent is within this distance of the
+  // bound of the root node
+  double optimalityGap = -1;
+
+  // TopK
+  unsigned topK = 1;
+
+  // AllSolutions: if set, solutions are spilled to "<solutionFile>.<locality>"
+  // whenever solutionBufferSize are held in memory (and once the search ends)
+  // rather than returned. Read them back with readSpilledSolutions.
+  std::string solutionFile;
+  std::uint64_t solutionBufferSize = 100000;
+
+  // Checkpointing (DepthBounded only). If checkpointFile is set the finished
+  // tasks, node counts and incumbent are written to it every
+  // checkpointInterval seconds and when the search ends. With restart set the
+  // search resumes from the checkpoint rather than starting from scratch.
+  std::string checkpointFile;
+  unsigned checkpointInterval = 300;
+  bool restart = false;
+
+  // Progress reporting (parallel skeletons). Every progressInterval seconds a
+  // JSON line of search statistics is written to stdout, or appended to
+  // progressFile if set. 0 disables reporting.
+  unsigned progressInterval = 0;
+  std::string progressFile;
+
+  // If set, and YewPar is built with YEWPAR_TRACING, a Chrome trace of the
+  // parallel skeleton's scheduler events is written here once the search ends
+  std::string traceFile;
+
   // Needed to push to registries on all nodes
   template <class Archive>
   void serialize(Archive & ar, const unsigned int version) {
     ar & maxDepth;
     ar & expectedObjective;
     ar & initialBound;
+    ar & warmStartTime;
     ar & spawnDepth;
+    ar & restartBase;
+    ar & nogoodLimit;
     ar & stealAll;
     ar & backtrackBudget;
+    ar & timeLimit;
+    ar & nodeLimit;
+    ar & optimalityGap;
+    ar & topK;
+    ar & solutionFile;
+    ar & solutionBufferSize;
+    ar & checkpointFile;
+    ar & checkpointInterval;
+    ar & restart;
+    ar & progressInterval;
+    ar & progressFile;
+    ar & traceFile;
   }
 };
 
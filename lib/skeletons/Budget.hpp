@@ -21,8 +21,12 @@ struct Budget {
   typedef typename API::skeleton_signature::bind<Args...>::type args;
 
   static constexpr bool isCountNodes = parameter::value_type<args, API::tag::CountNodes_, std::integral_constant<bool, false> >::type::value;
+  typedef typename parameter::value_type<args, API::tag::Enumeration, API::NoEnumeration>::type Enumerator;
+  static constexpr bool isEnumeration = !std::is_same<Enumerator, API::NoEnumeration>::value;
   static constexpr bool isOptimisation = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDepthBounded = parameter::value_type<args, API::tag::DepthLimited_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
   static constexpr unsigned maxStackDepth = parameter::value_type<args, API::tag::MaxStackDepth, std::integral_constant<unsigned, 5000> >::type::value;
@@ -33,14 +37,19 @@ struct Budget {
   typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
   typedef typename boundFn::return_type Bound;
   typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::IncumbentCallback, nullFn__>::type incumbentCallback;
+  typedef typename parameter::value_type<args, API::tag::WarmStart, nullFn__>::type warmStartFn;
 
   typedef typename parameter::value_type<args, API::tag::DepthBoundedPoolPolicy, Workstealing::Policies::DepthPoolPolicy>::type Policy;
 
   static void printSkeletonDetails() {
     hpx::cout << "Skeleton Type: Budget\n";
     hpx::cout << "CountNodes : " << std::boolalpha << isCountNodes << "\n";
+    hpx::cout << "Enumeration : " << std::boolalpha << isEnumeration << "\n";
     hpx::cout << "Optimisation: " << std::boolalpha << isOptimisation << "\n";
     hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "AllSolutions: " << std::boolalpha << isAllSolutions << "\n";
+    hpx::cout << "TopK: " << std::boolalpha << isTopK << "\n";
     hpx::cout << "DepthBounded: " << std::boolalpha << isDepthBounded << "\n";
     hpx::cout << "MaxStackDepth: " << maxStackDepth << "\n";
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
@@ -61,6 +70,7 @@ struct Budget {
                      const Node & n,
                      const API::Params<Bound> & params,
                      std::vector<uint64_t> & counts,
+                     Enumerator & acc,
                      std::vector<hpx::future<void> > & childFutures,
                      const unsigned childDepth) {
     auto reg = Registry<Space, Node, Bound>::gReg;
@@ -69,7 +79,7 @@ struct Budget {
     auto backtracks = 0;
 
     // Init the stack
-    StackElem<Generator> initElem(space, n);
+    StackElem<Generator> initElem(space, n, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
     GeneratorStack<Generator> genStack(maxStackDepth, initElem);
 
     if constexpr (isCountNodes) {
@@ -79,10 +89,8 @@ struct Budget {
     auto stackDepth = 0;
     while (stackDepth >= 0) {
 
-      if constexpr(isDecision) {
-        if (reg->stopSearch) {
-          return;
-        }
+      if (reg->stopped()) {
+        return;
       }
 
       // We spawn when we have exhausted our backtrack budget
@@ -116,8 +124,19 @@ struct Budget {
           continue;
         }
 
+        if constexpr(isEnumeration) {
+          acc.accumulate(child);
+          // The child is at the depth limit, enumerate it but don't go down
+          if constexpr(isDepthBounded) {
+            if (depth == reg->params.maxDepth) {
+              backtracks++;
+              continue;
+            }
+          }
+        }
+
         // Going down
-        const auto childGen = Generator(space, child);
+        const auto childGen = makeGenerator<Generator>(space, child, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
         stackDepth++;
         depth++;
 
@@ -127,7 +146,7 @@ struct Budget {
 
         // TODO: This only works correctly for countNodes where we can count without going into a node
         // It wouldn't work for a depthBounded optimisation problem for example.
-        if constexpr(isDepthBounded) {
+        if constexpr(isDepthBounded && !isEnumeration) {
           if (depth == reg->params.maxDepth) {
             stackDepth--;
             depth--;
@@ -156,14 +175,24 @@ struct Budget {
         countMap.resize(reg->params.maxDepth + 1);
     }
 
+    // Spawned nodes are accumulated by the task that runs them
+    Enumerator acc;
+    if constexpr (isEnumeration) {
+      acc.accumulate(taskRoot);
+    }
+
     std::vector<hpx::future<void> > childFutures;
-    expand(reg->space, taskRoot, reg->params, countMap, childFutures, childDepth);
+    expand(reg->space, taskRoot, reg->params, countMap, acc, childFutures, childDepth);
 
     // Atomically updates the (process) local counter
     if constexpr (isCountNodes) {
       reg->updateCounts(countMap);
     }
 
+    if constexpr (isEnumeration) {
+      EnumRegistry<Space, Node, Enumerator>::gReg->combine(acc);
+    }
+
     hpx::apply(hpx::util::bind([=](std::vector<hpx::future<void> > & futs) {
           hpx::wait_all(futs);
           hpx::async<hpx::lcos::base_lco_with_value<void>::set_value_action>(donePromiseId, true);
@@ -192,14 +221,33 @@ struct Budget {
 
   static auto search (const Space & space,
                       const Node & root,
-                      const API::Params<Bound> params = API::Params<Bound>()) {
+                      API::Params<Bound> params = API::Params<Bound>()) {
+    static_assert(!(isCountNodes && isEnumeration), "CountNodes and Enumeration can't be combined, count within the Enumeration instead");
+
     if constexpr (verbose) {
       printSkeletonDetails();
     }
 
+    // Seeds the incumbent (and raises params.initialBound) if we have a
+    // warm start heuristic
+    auto start = root;
+    if constexpr(isOptimisation) {
+      start = warmStart<Space, Node, Bound, Objcmp, warmStartFn>(space, root, params);
+    }
+
     hpx::wait_all(hpx::lcos::broadcast<InitRegistryAct<Space, Node, Bound> >(
         hpx::find_all_localities(), space, root, params));
 
+    if constexpr(isAllSolutions || isTopK) {
+      hpx::wait_all(hpx::lcos::broadcast<InitSolutionStoreAct<Space, Node, Bound, Objcmp> >(
+          hpx::find_all_localities(), params));
+    }
+
+    if constexpr(isEnumeration) {
+      hpx::wait_all(hpx::lcos::broadcast<InitEnumRegistryAct<Space, Node, Enumerator> >(
+          hpx::find_all_localities()));
+    }
+
     Policy::initPolicy();
 
     auto threadCount = hpx::get_os_thread_count() == 1 ? 1 : hpx::get_os_thread_count() - 1;
@@ -210,24 +258,41 @@ struct Budget {
       auto inc = hpx::new_<Incumbent>(hpx::find_here()).get();
       hpx::wait_all(hpx::lcos::broadcast<UpdateGlobalIncumbentAct<Space, Node, Bound> >(
           hpx::find_all_localities(), inc));
-      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(root, params.initialBound);
+      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(start, params.initialBound);
+      setIncumbentCallback<Space, Node, Bound, Objcmp, Verbose, incumbentCallback>();
     }
 
+    auto monitor = startSearchMonitor<Space, Node, Bound, boundFn, isOptimisation, verbose>(space, root, params);
+
     createTask(1, root).get();
 
     hpx::wait_all(hpx::lcos::broadcast<Workstealing::Scheduler::stopSchedulers_act>(
         hpx::find_all_localities()));
 
+    monitor.stop();
+
+    if (!params.traceFile.empty()) {
+      Trace::writeChromeTrace(params.traceFile);
+    }
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      NodeCounters::printSummary();
+    }
+
     // Return the right thing
     if constexpr(isCountNodes) {
       return totalNodeCounts<Space, Node, Bound>(params.maxDepth);
+    } else if constexpr(isEnumeration) {
+      return totalEnumeration<Space, Node, Enumerator>();
+    } else if constexpr(isAllSolutions || isTopK) {
+      return collectSolutions<Space, Node, Bound, Objcmp, isTopK>(params);
     } else if constexpr(isOptimisation || isDecision) {
       auto reg = Registry<Space, Node, Bound>::gReg;
 
       typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
       return hpx::async<getInc>(reg->globalIncumbent).get();
     } else {
-      static_assert(isCountNodes || isOptimisation || isDecision, "Please provide a supported search type: CountNodes, Optimisation, Decision");
+      static_assert(isCountNodes || isEnumeration || isOptimisation || isDecision || isAllSolutions || isTopK, "Please provide a supported search type: CountNodes, Enumeration, Optimisation, Decision, AllSolutions, TopK");
     }
   }
 };
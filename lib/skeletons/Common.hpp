@@ -1,8 +1,23 @@
 #ifndef SKELETONS_COMMON_HPP
 #define SKELETONS_COMMON_HPP
 
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <optional>
+
+#include <hpx/lcos/reduce.hpp>
+
+#include "util/NodeCounters.hpp"
+#include "util/NodeGenerator.hpp"
 #include "util/Registry.hpp"
+#include "util/EnumRegistry.hpp"
 #include "util/Incumbent.hpp"
+#include "util/SolutionStore.hpp"
+#include "util/SearchMonitor.hpp"
+#include "util/Trace.hpp"
+#include "util/WarmStart.hpp"
+#include "util/func.hpp"
 
 namespace YewPar { namespace Skeletons {
 
@@ -21,6 +36,12 @@ template<typename Space, typename Node, typename Bound, typename Cmp, typename V
 static void updateIncumbent(const Node & node, const Bound & bnd) {
   auto reg = Registry<Space, Node, Bound>::gReg;
 
+  if constexpr(std::is_arithmetic<Bound>::value) {
+    Trace::record(Trace::Event::Incumbent, static_cast<std::int64_t>(bnd));
+  } else {
+    Trace::record(Trace::Event::Incumbent);
+  }
+
   (*reg).template updateRegistryBound<Cmp>(bnd);
   hpx::lcos::broadcast<UpdateRegistryBoundAct<Space, Node, Bound, Cmp> >(
       hpx::find_all_localities(), bnd);
@@ -29,6 +50,71 @@ static void updateIncumbent(const Node & node, const Bound & bnd) {
   hpx::async<act>(reg->globalIncumbent, node).get();
 }
 
+template<typename Space, typename Node, typename Bound, typename Cmp, typename Verbose, typename Callback>
+static void setIncumbentCallback() {
+  if constexpr(!std::is_same<Callback, nullFn__>::value) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    auto inc = hpx::get_ptr<Incumbent>(hpx::launch::sync, reg->globalIncumbent);
+    inc->template setCallback<Node, Bound, Cmp, Verbose>(Callback::fn_ptr());
+  }
+}
+
+// Anytime search. Starts monitoring the Params limits; the optimality gap is
+// measured against the bound of the root node so it requires a bound function.
+template<typename Space, typename Node, typename Bound, typename BoundFn, bool isOptimisation, unsigned verbose>
+static SearchMonitor<Space, Node, Bound> startSearchMonitor(const Space & space,
+                                                            const Node & root,
+                                                            const API::Params<Bound> & params) {
+  std::function<bool()> gapClosed;
+  if constexpr(isOptimisation && !std::is_same<BoundFn, nullFn__>::value && std::is_arithmetic<Bound>::value) {
+    if (params.optimalityGap >= 0) {
+      auto rootBound = BoundFn::invoke(space, root);
+      auto gap = params.optimalityGap;
+      gapClosed = [=]() {
+        auto best = Registry<Space, Node, Bound>::gReg->localBound.load();
+        return std::abs(static_cast<double>(rootBound) - static_cast<double>(best)) <= gap;
+      };
+    }
+  }
+
+  SearchMonitor<Space, Node, Bound> monitor;
+  monitor.start(params, gapClosed, verbose, isOptimisation);
+  return monitor;
+}
+
+// Node statistics (see NodeCounters). Without YEWPAR_NODE_COUNTERS we only
+// count when a node limit or progress reporting needs the numbers.
+template<typename Bound>
+static bool countingNodes(const API::Params<Bound> & params) {
+  return NodeCounters::enabled || params.nodeLimit > 0 || params.progressInterval > 0;
+}
+
+template<typename Space, typename Node, typename Bound>
+static void countProcessedNode(const API::Params<Bound> & params) {
+  static constexpr std::uint64_t checkInterval = 1024;
+
+  auto n = NodeCounters::countProcessed();
+  if (params.nodeLimit > 0 && n % checkInterval == 0) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    // Locally exceeding the limit means we've globally exceeded it, other
+    // cases are caught by the SearchMonitor
+    if (!reg->stopped() && NodeCounters::localTotals().processed >= params.nodeLimit) {
+      hpx::lcos::broadcast<SetStopFlagAct<Space, Node, Bound> >(hpx::find_all_localities());
+    }
+  }
+}
+
+// A break from PruneLevel prunes the node and the rest of its level
+template<bool pruneLevel, typename Bound>
+static void countPrunedNode(const API::Params<Bound> & params) {
+  if (countingNodes(params)) {
+    NodeCounters::countPruned();
+    if constexpr(pruneLevel) {
+      NodeCounters::countBroken();
+    }
+  }
+}
+
 template<typename Space, typename Node, typename Bound>
 static std::vector<std::uint64_t> totalNodeCounts(const unsigned maxDepth) {
   auto cntList = hpx::lcos::broadcast<GetCountsAct<Space, Node, Bound> >(
@@ -44,6 +130,61 @@ static std::vector<std::uint64_t> totalNodeCounts(const unsigned maxDepth) {
   return res;
 }
 
+// TopK: offer a node to the local store and share any improvement of the k-th
+// best value as the new pruning bound
+template<typename Space, typename Node, typename Bound, typename Cmp>
+static void offerSolution(const Node & node) {
+  Bound kth;
+  if (SolutionStore<Space, Node, Bound, Cmp>::gReg->offer(node, kth)) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    (*reg).template updateRegistryBound<Cmp>(kth);
+    hpx::lcos::broadcast<UpdateRegistryBoundAct<Space, Node, Bound, Cmp> >(
+        hpx::find_all_localities(), kth);
+  }
+}
+
+// AllSolutions/TopK: gather the solutions held by each locality
+template<typename Space, typename Node, typename Bound, typename Cmp, bool isTopK>
+static std::vector<Node> collectSolutions(const API::Params<Bound> & params) {
+  auto perLocality = hpx::lcos::broadcast<GetSolutionsAct<Space, Node, Bound, Cmp> >(
+      hpx::find_all_localities()).get();
+
+  std::vector<Node> res;
+  for (const auto & sols : perLocality) {
+    res.insert(res.end(), sols.begin(), sols.end());
+  }
+
+  if constexpr(isTopK) {
+    std::sort(res.begin(), res.end(), [](const Node & a, const Node & b) {
+        Cmp cmp;
+        return cmp(a.getObj(), b.getObj());
+      });
+    if (res.size() > params.topK) {
+      res.erase(res.begin() + params.topK, res.end());
+    }
+  }
+
+  return res;
+}
+
+// Combine the Enumeration results of all localities
+template<typename Space, typename Node, typename Enum>
+static Enum totalEnumeration() {
+  return hpx::lcos::reduce<GetEnumeratorAct<Space, Node, Enum> >(
+      hpx::find_all_localities(), CombineEnumerators<Enum>()).get();
+}
+
+// The bound generators are given (see util/NodeGenerator.hpp): this worker's
+// cached incumbent bound in Optimisation and Decision searches, none otherwise
+template <typename Space, typename Node, typename Bound, bool hasIncumbent>
+std::optional<Bound> generatorBound() {
+  if constexpr(hasIncumbent) {
+    return Registry<Space, Node, Bound>::gReg->cachedBound();
+  } else {
+    return std::nullopt;
+  }
+}
+
 template <typename Generator>
 struct StackElem {
   unsigned seen;
@@ -51,9 +192,11 @@ struct StackElem {
   Generator gen;
 
   StackElem(Generator gen) : seen(0), gen(gen) {};
+  template <typename Bound>
   StackElem(const typename Generator::Spacetype & s,
-            const typename Generator::Nodetype & n)
-      : seen(0), node(n), gen(Generator(s, node)) {};
+            const typename Generator::Nodetype & n,
+            const std::optional<Bound> & bnd)
+      : seen(0), node(n), gen(makeGenerator<Generator>(s, node, bnd)) {};
 };
 
 template <typename Generator>
@@ -68,6 +211,8 @@ struct ProcessNode {
 
   static constexpr bool isOptimisation = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
 
   typedef typename parameter::value_type<args, API::tag::Verbose_, std::integral_constant<unsigned, 0> >::type Verbose;
@@ -79,6 +224,10 @@ struct ProcessNode {
   static ProcessNodeRet processNode(const API::Params<Bound> & params,
                                     const Space & space,
                                     const Node & c) {
+    if (countingNodes(params)) {
+      countProcessedNode<Space, Node, Bound>(params);
+    }
+
     if constexpr(isDecision) {
         if (c.getObj() == params.expectedObjective) {
           updateIncumbent<Space, Node, Bound, Objcmp, Verbose>(c, c.getObj());
@@ -87,11 +236,20 @@ struct ProcessNode {
         }
       }
 
+    // Solutions are leaves: record them and move on
+    if constexpr(isAllSolutions) {
+        if (c.getObj() == params.expectedObjective) {
+          SolutionStore<Space, Node, Bound, Objcmp>::gReg->addSolution(c);
+          return ProcessNodeRet::Prune;
+        }
+      }
+
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
         Objcmp cmp;
         auto bnd  = boundFn::invoke(space, c);
-        if constexpr(isDecision) {
+        if constexpr(isDecision || isAllSolutions) {
             if (!cmp(bnd, params.expectedObjective) && bnd != params.expectedObjective) {
+              countPrunedNode<pruneLevel>(params);
               if constexpr(pruneLevel) {
                   return ProcessNodeRet::Break;
                 } else {
@@ -101,8 +259,9 @@ struct ProcessNode {
             // B&B Case
           } else {
           auto reg = Registry<Space, Node, Bound>::gReg;
-          auto best = reg->localBound.load();
+          auto best = reg->cachedBound();
           if (!cmp(bnd, best)) {
+            countPrunedNode<pruneLevel>(params);
             if constexpr(pruneLevel) {
                 return ProcessNodeRet::Break;
             } else {
@@ -114,13 +273,24 @@ struct ProcessNode {
 
     if constexpr(isOptimisation) {
         auto reg = Registry<Space, Node, Bound>::gReg;
-        auto best = reg->localBound.load();
+        auto best = reg->cachedBound();
 
+        // Re-check against the real bound to avoid sending stale improvements
         Objcmp cmp;
-        if (cmp(c.getObj(),best)) {
+        if (cmp(c.getObj(), best) && cmp(c.getObj(), reg->localBound.load(std::memory_order_relaxed))) {
           updateIncumbent<Space, Node, Bound, Objcmp, Verbose>(c, c.getObj());
         }
     }
+
+    if constexpr(isTopK) {
+        auto reg = Registry<Space, Node, Bound>::gReg;
+        auto kth = reg->cachedBound();
+
+        Objcmp cmp;
+        if (cmp(c.getObj(), kth)) {
+          offerSolution<Space, Node, Bound, Objcmp>(c);
+        }
+    }
     return ProcessNodeRet::Continue;
   }
 };
@@ -2,6 +2,7 @@
 #define SKELETONS_DEPTHSPAWN_HPP
 
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <cstdint>
 
@@ -12,6 +13,7 @@
 #include <hpx/lcos/broadcast.hpp>
 #include <hpx/include/iostreams.hpp>
 
+#include "util/Checkpoint.hpp"
 #include "util/NodeGenerator.hpp"
 #include "util/Registry.hpp"
 #include "util/Incumbent.hpp"
@@ -41,8 +43,12 @@ struct DepthBounded {
   typedef typename API::skeleton_signature::bind<Args...>::type args;
 
   static constexpr bool isCountNodes = parameter::value_type<args, API::tag::CountNodes_, std::integral_constant<bool, false> >::type::value;
+  typedef typename parameter::value_type<args, API::tag::Enumeration, API::NoEnumeration>::type Enumerator;
+  static constexpr bool isEnumeration = !std::is_same<Enumerator, API::NoEnumeration>::value;
   static constexpr bool isOptimisation = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDepthLimited = parameter::value_type<args, API::tag::DepthLimited_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
 
@@ -52,15 +58,23 @@ struct DepthBounded {
   typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
   typedef typename boundFn::return_type Bound;
   typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::IncumbentCallback, nullFn__>::type incumbentCallback;
+  typedef typename parameter::value_type<args, API::tag::WarmStart, nullFn__>::type warmStartFn;
 
   typedef typename parameter::value_type<args, API::tag::DepthBoundedPoolPolicy, Workstealing::Policies::DepthPoolPolicy>::type Policy;
 
+  // Checkpoints only hold counts and the incumbent, not general results
+  static constexpr bool canCheckpoint = isCountNodes || isOptimisation || isDecision;
+
   static void printSkeletonDetails(const API::Params<Bound> & params) {
     hpx::cout << "Skeleton Type: DepthBounded\n";
     hpx::cout << "d_cutoff: " << params.spawnDepth << "\n";
     hpx::cout << "CountNodes : " << std::boolalpha << isCountNodes << "\n";
+    hpx::cout << "Enumeration : " << std::boolalpha << isEnumeration << "\n";
     hpx::cout << "Optimisation: " << std::boolalpha << isOptimisation << "\n";
     hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "AllSolutions: " << std::boolalpha << isAllSolutions << "\n";
+    hpx::cout << "TopK: " << std::boolalpha << isTopK << "\n";
     hpx::cout << "DepthLimited: " << std::boolalpha << isDepthLimited << "\n";
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
         hpx::cout << "Using Bounding: true\n";
@@ -80,15 +94,29 @@ struct DepthBounded {
                                const Node & n,
                                const API::Params<Bound> & params,
                                std::vector<uint64_t> & counts,
+                               Enumerator & acc,
                                std::vector<hpx::future<void> > & childFutures,
-                               const unsigned childDepth) {
-    Generator newCands = Generator(space, n);
+                               const unsigned childDepth,
+                               const TaskPath & path) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    if (reg->stopped()) {
+      return;
+    }
+
+    // Checkpoints name tasks by child index, so the children above the spawn
+    // depth mustn't depend on the incumbent (see util/NodeGenerator.hpp)
+    auto bnd = generatorBound<Space, Node, Bound, isOptimisation || isDecision>();
+    if (!params.checkpointFile.empty()) {
+      bnd.reset();
+    }
+    Generator newCands = makeGenerator<Generator>(space, n, bnd);
 
     if constexpr(isCountNodes) {
         counts[childDepth] += newCands.numChildren;
     }
 
-    if constexpr(isDepthLimited) {
+    // Enumerations still visit the nodes at the depth limit
+    if constexpr(isDepthLimited && !isEnumeration) {
         if (childDepth == params.maxDepth) {
           return;
         }
@@ -99,11 +127,28 @@ struct DepthBounded {
 
       auto pn = ProcessNode<Space, Node, Args...>::processNode(params, space, c);
       if (pn == ProcessNodeRet::Exit) { return; }
+      else if (pn == ProcessNodeRet::Prune) { continue; }
       else if (pn == ProcessNodeRet::Break) { break; }
       //default continue
 
+      if constexpr(isEnumeration) {
+        acc.accumulate(c);
+        if constexpr(isDepthLimited) {
+          if (childDepth == params.maxDepth) {
+            continue;
+          }
+        }
+      }
+
+      // Paths are only tracked when they might be checkpointed
+      TaskPath childPath;
+      if (!params.checkpointFile.empty()) {
+        childPath = path;
+        childPath.push_back(i);
+      }
+
       // Spawn new tasks for all children (that are still alive after pruning)
-      childFutures.push_back(createTask(childDepth + 1, c));
+      childFutures.push_back(createTask(childDepth + 1, c, childPath));
     }
   }
 
@@ -111,21 +156,21 @@ struct DepthBounded {
                              const Node & n,
                              const API::Params<Bound> & params,
                              std::vector<uint64_t> & counts,
+                             Enumerator & acc,
                              const unsigned childDepth) {
     auto reg = Registry<Space, Node, Bound>::gReg;
-    Generator newCands = Generator(space, n);
+    Generator newCands = makeGenerator<Generator>(space, n, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
 
-    if constexpr(isDecision) {
-        if (reg->stopSearch) {
-          return;
-        }
-      }
+    if (reg->stopped()) {
+      return;
+    }
 
     if constexpr(isCountNodes) {
         counts[childDepth] += newCands.numChildren;
     }
 
-    if constexpr(isDepthLimited) {
+    // Enumerations still visit the nodes at the depth limit
+    if constexpr(isDepthLimited && !isEnumeration) {
         if (childDepth == params.maxDepth) {
           return;
         }
@@ -139,12 +184,22 @@ struct DepthBounded {
       else if (pn == ProcessNodeRet::Prune) { continue; }
       else if (pn == ProcessNodeRet::Break) { break; }
 
-      expandNoSpawns(space, c, params, counts, childDepth + 1);
+      if constexpr(isEnumeration) {
+        acc.accumulate(c);
+        if constexpr(isDepthLimited) {
+          if (childDepth == params.maxDepth) {
+            continue;
+          }
+        }
+      }
+
+      expandNoSpawns(space, c, params, counts, acc, childDepth + 1);
     }
   }
 
   static void subtreeTask(const Node taskRoot,
                           const unsigned childDepth,
+                          const TaskPath path,
                           const hpx::naming::id_type donePromiseId) {
     auto reg = Registry<Space, Node, Bound>::gReg;
 
@@ -153,12 +208,14 @@ struct DepthBounded {
         countMap.resize(reg->params.maxDepth + 1);
     }
 
+    Enumerator acc;
+
     std::vector<hpx::future<void> > childFutures;
 
     if (childDepth <= reg->params.spawnDepth) {
-      expandWithSpawns(reg->space, taskRoot, reg->params, countMap, childFutures, childDepth);
+      expandWithSpawns(reg->space, taskRoot, reg->params, countMap, acc, childFutures, childDepth, path);
     } else {
-      expandNoSpawns(reg->space, taskRoot, reg->params, countMap, childDepth);
+      expandNoSpawns(reg->space, taskRoot, reg->params, countMap, acc, childDepth);
     }
 
     // Atomically updates the (process) local counter
@@ -166,6 +223,18 @@ struct DepthBounded {
       reg->updateCounts(countMap);
     }
 
+    if constexpr (isEnumeration) {
+      EnumRegistry<Space, Node, Enumerator>::gReg->combine(acc);
+    }
+
+    // Tasks below the spawn depth explore their whole subtree. If the search
+    // wasn't stopped during it they never need to run again.
+    if constexpr (canCheckpoint) {
+      if (!reg->params.checkpointFile.empty() && childDepth > reg->params.spawnDepth && !reg->stopped()) {
+        CheckpointRegistry<Space, Node, Bound>::gReg->taskDone(path, countMap);
+      }
+    }
+
     hpx::apply(hpx::util::bind([=](std::vector<hpx::future<void> > & futs) {
           hpx::wait_all(futs);
           hpx::async<hpx::lcos::base_lco_with_value<void>::set_value_action>(donePromiseId, true);
@@ -173,14 +242,20 @@ struct DepthBounded {
   }
 
   static hpx::future<void> createTask(const unsigned childDepth,
-                                      const Node & taskRoot) {
+                                      const Node & taskRoot,
+                                      const TaskPath & path) {
+    // Already finished before a restart
+    if (CheckpointRegistry<Space, Node, Bound>::gReg->shouldSkip(path)) {
+      return hpx::make_ready_future();
+    }
+
     hpx::lcos::promise<void> prom;
     auto pfut = prom.get_future();
     auto pid  = prom.get_id();
 
     DepthBounded_::SubtreeTask<Generator, Args...> t;
     hpx::util::function<void(hpx::naming::id_type)> task;
-    task = hpx::util::bind(t, hpx::util::placeholders::_1, taskRoot, childDepth, pid);
+    task = hpx::util::bind(t, hpx::util::placeholders::_1, taskRoot, childDepth, path, pid);
 
     auto workPool = std::static_pointer_cast<Policy>(Workstealing::Scheduler::local_policy);
     if constexpr (std::is_same<Policy, Workstealing::Policies::Workpool>::value) {
@@ -192,16 +267,96 @@ struct DepthBounded {
      return pfut;
   }
 
+  // Gather the finished tasks from every locality and save them along with the
+  // current incumbent. Called periodically from a CheckpointWriter.
+  static void writeCheckpoint(const API::Params<Bound> & params) {
+    Checkpoint<Node> cp;
+    cp.spawnDepth = params.spawnDepth;
+
+    // The incumbent must be read after the finished tasks so that it's at least
+    // as good as anything found within them
+    auto data = hpx::lcos::broadcast<GetCheckpointDataAct<Space, Node, Bound> >(
+        hpx::find_all_localities()).get();
+    for (const auto & d : data) {
+      cp.data.merge(d);
+    }
+
+    if constexpr(isOptimisation) {
+      auto reg = Registry<Space, Node, Bound>::gReg;
+      typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
+      cp.hasIncumbent = true;
+      cp.incumbent = hpx::async<getInc>(reg->globalIncumbent).get();
+    }
+
+    writeCheckpointFile(params.checkpointFile, cp);
+
+    if constexpr(verbose >= 1) {
+      hpx::cout << (boost::format("Checkpoint written: %1% tasks complete\n") % cp.data.done.size()) << hpx::flush;
+    }
+  }
+
   static auto search (const Space & space,
                       const Node & root,
-                      const API::Params<Bound> params = API::Params<Bound>()) {
+                      API::Params<Bound> params = API::Params<Bound>()) {
+    static_assert(!(isCountNodes && isEnumeration), "CountNodes and Enumeration can't be combined, count within the Enumeration instead");
+
     if constexpr (verbose) {
         printSkeletonDetails(params);
     }
 
+    // Seeds the incumbent (and raises params.initialBound) if we have a
+    // warm start heuristic
+    auto start = root;
+    if constexpr(isOptimisation) {
+      start = warmStart<Space, Node, Bound, Objcmp, warmStartFn>(space, root, params);
+    }
+
     hpx::wait_all(hpx::lcos::broadcast<InitRegistryAct<Space, Node, Bound> >(
         hpx::find_all_localities(), space, root, params));
 
+    const bool checkpointing = canCheckpoint && !params.checkpointFile.empty();
+    if (!params.checkpointFile.empty() && !canCheckpoint) {
+      hpx::cout << "Warning: checkpointing is only supported for CountNodes, Optimisation and Decision searches\n" << hpx::flush;
+    }
+
+    Checkpoint<Node> restartFrom;
+    if (checkpointing && params.restart) {
+      restartFrom = readCheckpointFile<Node>(params.checkpointFile);
+      if (restartFrom.spawnDepth != params.spawnDepth) {
+        throw std::runtime_error("Checkpoint was taken with a different spawnDepth");
+      }
+      if constexpr(verbose >= 1) {
+        hpx::cout << (boost::format("Restarting from checkpoint: %1% tasks complete\n") % restartFrom.data.done.size()) << hpx::flush;
+      }
+    }
+
+    hpx::wait_all(hpx::lcos::broadcast<InitCheckpointRegistryAct<Space, Node, Bound> >(
+        hpx::find_all_localities(), restartFrom.data.done));
+
+    if (checkpointing && params.restart) {
+      CheckpointRegistry<Space, Node, Bound>::gReg->restore(restartFrom.data);
+      if constexpr(isCountNodes) {
+        auto counts = restartFrom.data.counts;
+        counts.resize(params.maxDepth + 1);
+        Registry<Space, Node, Bound>::gReg->updateCounts(counts);
+      }
+    }
+
+    if constexpr(isAllSolutions || isTopK) {
+      hpx::wait_all(hpx::lcos::broadcast<InitSolutionStoreAct<Space, Node, Bound, Objcmp> >(
+          hpx::find_all_localities(), params));
+    }
+
+    if constexpr(isEnumeration) {
+      hpx::wait_all(hpx::lcos::broadcast<InitEnumRegistryAct<Space, Node, Enumerator> >(
+          hpx::find_all_localities()));
+
+      // Children are accumulated by their parent so account for the root here
+      Enumerator rootAcc;
+      rootAcc.accumulate(root);
+      EnumRegistry<Space, Node, Enumerator>::gReg->combine(rootAcc);
+    }
+
     Policy::initPolicy();
 
     auto threadCount = hpx::get_os_thread_count() == 1 ? 1 : hpx::get_os_thread_count() - 1;
@@ -212,25 +367,68 @@ struct DepthBounded {
       auto inc = hpx::new_<Incumbent>(hpx::find_here()).get();
       hpx::wait_all(hpx::lcos::broadcast<UpdateGlobalIncumbentAct<Space, Node, Bound> >(
           hpx::find_all_localities(), inc));
-      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(root, params.initialBound);
+      if (restartFrom.hasIncumbent) {
+        // Resume pruning from where we left off, unless the warm start (or
+        // the initial bound) is already better
+        Objcmp cmp;
+        auto incumbent = restartFrom.incumbent;
+        auto bnd = incumbent.getObj();
+        if (cmp(params.initialBound, bnd)) {
+          incumbent = start;
+          bnd = params.initialBound;
+        }
+        hpx::wait_all(hpx::lcos::broadcast<UpdateRegistryBoundAct<Space, Node, Bound, Objcmp> >(
+            hpx::find_all_localities(), bnd));
+        initIncumbent<Space, Node, Bound, Objcmp, Verbose>(incumbent, bnd);
+      } else {
+        initIncumbent<Space, Node, Bound, Objcmp, Verbose>(start, params.initialBound);
+      }
+      setIncumbentCallback<Space, Node, Bound, Objcmp, Verbose, incumbentCallback>();
+    }
+
+    auto monitor = startSearchMonitor<Space, Node, Bound, boundFn, isOptimisation, verbose>(space, root, params);
+
+    CheckpointWriter checkpointWriter;
+    if (checkpointing) {
+      checkpointWriter.start(params.checkpointInterval, [=]() { writeCheckpoint(params); });
     }
 
     // Issue is updateCounts by the looks of things. Something probably isn't initialised correctly.
-    createTask(1, root).get();
+    createTask(1, root, TaskPath()).get();
 
     hpx::wait_all(hpx::lcos::broadcast<Workstealing::Scheduler::stopSchedulers_act>(
         hpx::find_all_localities()));
 
+    monitor.stop();
+
+    if (!params.traceFile.empty()) {
+      Trace::writeChromeTrace(params.traceFile);
+    }
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      NodeCounters::printSummary();
+    }
+
+    if (checkpointing) {
+      checkpointWriter.stop();
+      // Allows a search stopped by a limit to carry on later
+      writeCheckpoint(params);
+    }
+
     // Return the right thing
     if constexpr(isCountNodes) {
       return totalNodeCounts<Space, Node, Bound>(params.maxDepth);
+    } else if constexpr(isEnumeration) {
+      return totalEnumeration<Space, Node, Enumerator>();
+    } else if constexpr(isAllSolutions || isTopK) {
+      return collectSolutions<Space, Node, Bound, Objcmp, isTopK>(params);
     } else if constexpr(isOptimisation || isDecision) {
       auto reg = Registry<Space, Node, Bound>::gReg;
 
       typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
       return hpx::async<getInc>(reg->globalIncumbent).get();
     } else {
-      static_assert(isCountNodes || isOptimisation || isDecision, "Please provide a supported search type: CountNodes, Optimisation, Decision");
+      static_assert(isCountNodes || isEnumeration || isOptimisation || isDecision || isAllSolutions || isTopK, "Please provide a supported search type: CountNodes, Enumeration, Optimisation, Decision, AllSolutions, TopK");
     }
   }
 };
@@ -39,8 +39,12 @@ struct Ordered {
   static constexpr bool isCountNodes = parameter::value_type<args, API::tag::CountNodes_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isOptimisation = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDepthBounded = parameter::value_type<args, API::tag::DepthLimited_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
+  static_assert(std::is_same<typename parameter::value_type<args, API::tag::Enumeration, API::NoEnumeration>::type, API::NoEnumeration>::value,
+                "The Ordered skeleton does not support Enumeration searches");
   static constexpr bool discrepancySearch = parameter::value_type<args, API::tag::DiscrepancySearch_, std::integral_constant<bool, false> >::type::value;
 
   typedef typename parameter::value_type<args, API::tag::Verbose_, std::integral_constant<unsigned, 0> >::type Verbose;
@@ -49,12 +53,16 @@ struct Ordered {
   typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
   typedef typename boundFn::return_type Bound;
   typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::IncumbentCallback, nullFn__>::type incumbentCallback;
+  typedef typename parameter::value_type<args, API::tag::WarmStart, nullFn__>::type warmStartFn;
 
   static void printSkeletonDetails() {
     hpx::cout << "Skeleton Type: Ordered\n";
     hpx::cout << "CountNodes : " << std::boolalpha << isCountNodes << "\n";
     hpx::cout << "Optimisation: " << std::boolalpha << isOptimisation << "\n";
     hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "AllSolutions: " << std::boolalpha << isAllSolutions << "\n";
+    hpx::cout << "TopK: " << std::boolalpha << isTopK << "\n";
     hpx::cout << "DepthBounded: " << std::boolalpha << isDepthBounded << "\n";
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
         hpx::cout << "Using Bounding: true\n";
@@ -87,7 +95,7 @@ struct Ordered {
         if (depth == 0) {
           tasks.emplace_back(OrderedTask(n, numDisc));
         } else {
-          auto newCands = Generator(space, n);
+          auto newCands = makeGenerator<Generator>(space, n, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
           for (auto i = 0; i < newCands.numChildren; ++i) {
             auto node = newCands.next();
             fn(depth - 1, numDisc + i, node);
@@ -102,7 +110,7 @@ struct Ordered {
         if (depth == 0) {
           tasks.emplace_back(OrderedTask(n, 0));
         } else {
-          auto newCands = Generator(space, n);
+          auto newCands = makeGenerator<Generator>(space, n, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
           for (auto i = 0; i < newCands.numChildren; ++i) {
             auto node = newCands.next();
             fn(depth - 1, node);
@@ -131,13 +139,11 @@ struct Ordered {
                              std::vector<uint64_t> & counts,
                              const unsigned childDepth) {
     auto reg = Registry<Space, Node, Bound>::gReg;
-    Generator newCands = Generator(space, n);
+    Generator newCands = makeGenerator<Generator>(space, n, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
 
-    if constexpr(isDecision) {
-        if (reg->stopSearch) {
-          return;
-        }
-      }
+    if (reg->stopped()) {
+      return;
+    }
 
     if constexpr(isCountNodes) {
         counts[childDepth] += newCands.numChildren;
@@ -163,21 +169,36 @@ struct Ordered {
 
   static auto search (const Space & space,
                       const Node & root,
-                      const API::Params<Bound> params = API::Params<Bound>()) {
+                      API::Params<Bound> params = API::Params<Bound>()) {
     if constexpr(verbose) {
       printSkeletonDetails();
     }
 
+    // Seeds the incumbent (and raises params.initialBound) if we have a
+    // warm start heuristic
+    auto start = root;
+    if constexpr(isOptimisation) {
+      start = warmStart<Space, Node, Bound, Objcmp, warmStartFn>(space, root, params);
+    }
+
     hpx::wait_all(hpx::lcos::broadcast<InitRegistryAct<Space, Node, Bound> >(
         hpx::find_all_localities(), space, root, params));
 
+    if constexpr(isAllSolutions || isTopK) {
+      hpx::wait_all(hpx::lcos::broadcast<InitSolutionStoreAct<Space, Node, Bound, Objcmp> >(
+          hpx::find_all_localities(), params));
+    }
+
     if constexpr(isOptimisation || isDecision) {
       auto inc = hpx::new_<Incumbent>(hpx::find_here()).get();
       hpx::wait_all(hpx::lcos::broadcast<UpdateGlobalIncumbentAct<Space, Node, Bound> >(
           hpx::find_all_localities(), inc));
-      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(root, params.initialBound);
+      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(start, params.initialBound);
+      setIncumbentCallback<Space, Node, Bound, Objcmp, Verbose, incumbentCallback>();
     }
 
+    auto monitor = startSearchMonitor<Space, Node, Bound, boundFn, isOptimisation, verbose>(space, root, params);
+
     Workstealing::Policies::PriorityOrderedPolicy::initPolicy();
 
     auto spawn_start_time = std::chrono::steady_clock::now();
@@ -214,16 +235,14 @@ struct Ordered {
     auto reg = Registry<Space, Node, Bound>::gReg;
     for (auto & t : tasks) {
       // Allow early termination of sequential thread
-      if constexpr(isDecision) {
-        if (reg->stopSearch) {
-          break;
-        }
+      if (reg->stopped()) {
+        break;
       }
 
       // Quick prune path to avoid writing global flags
-      if constexpr(isOptimisation && !std::is_same<boundFn, nullFn__>::value) {
+      if constexpr((isOptimisation || isTopK) && !std::is_same<boundFn, nullFn__>::value) {
         Objcmp cmp;
-        auto best = reg->localBound.load();
+        auto best = reg->localBound.load(std::memory_order_relaxed);
         auto bnd  = boundFn::invoke(space, t.node);
         if (!cmp(bnd,best)) {
           continue;
@@ -245,15 +264,27 @@ struct Ordered {
     hpx::wait_all(hpx::lcos::broadcast<Workstealing::Scheduler::stopSchedulers_act>(
         hpx::find_all_localities()));
 
+    monitor.stop();
+
+    if (!params.traceFile.empty()) {
+      Trace::writeChromeTrace(params.traceFile);
+    }
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      NodeCounters::printSummary();
+    }
+
     // Return the right thing
     if constexpr(isCountNodes) {
       return totalNodeCounts<Space, Node, Bound>(params.maxDepth);
+    } else if constexpr(isAllSolutions || isTopK) {
+      return collectSolutions<Space, Node, Bound, Objcmp, isTopK>(params);
     } else if constexpr(isOptimisation || isDecision) {
       auto reg = Registry<Space, Node, Bound>::gReg;
       typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
       return hpx::async<getInc>(reg->globalIncumbent).get();
     } else {
-      static_assert(isCountNodes || isOptimisation || isDecision, "Please provide a supported search type: CountNodes, Optimisation, Decision");
+      static_assert(isCountNodes || isOptimisation || isDecision || isAllSolutions || isTopK, "Please provide a supported search type: CountNodes, Optimisation, Decision, AllSolutions, TopK");
     }
   }
 
@@ -261,16 +292,14 @@ struct Ordered {
                           const hpx::naming::id_type started) {
     // Don't bother checking if the sequential thread has done this task since we are stopping anyway
     auto reg = Registry<Space, Node, Bound>::gReg;
-    if constexpr (isDecision) {
-      if (reg->stopSearch) {
-        return;
-      }
+    if (reg->stopped()) {
+      return;
     }
 
     // Quick prune path
-    if constexpr(isOptimisation && !std::is_same<boundFn, nullFn__>::value) {
+    if constexpr((isOptimisation || isTopK) && !std::is_same<boundFn, nullFn__>::value) {
       Objcmp cmp;
-      auto best = reg->localBound.load();
+      auto best = reg->localBound.load(std::memory_order_relaxed);
       auto bnd  = boundFn::invoke(reg->space, taskRoot);
       if (!cmp(bnd,best)) {
         return;
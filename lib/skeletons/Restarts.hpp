@@ -0,0 +1,349 @@
+#ifndef SKELETONS_RESTARTS_HPP
+#define SKELETONS_RESTARTS_HPP
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "API.hpp"
+
+#include <hpx/include/async.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/broadcast.hpp>
+#include <hpx/lcos/wait_all.hpp>
+#include <hpx/runtime/get_locality_id.hpp>
+#include <hpx/runtime/get_os_thread_count.hpp>
+
+#include <boost/format.hpp>
+
+#include "util/NodeGenerator.hpp"
+#include "util/NogoodStore.hpp"
+#include "util/Registry.hpp"
+#include "util/Incumbent.hpp"
+#include "util/func.hpp"
+#include "util/util.hpp"
+
+#include "Common.hpp"
+
+namespace YewPar { namespace Skeletons {
+
+// Portfolio search with randomised restarts (Decision only). Rather than
+// splitting the tree, every worker on every locality searches it from the root
+// with its own value ordering, starting again after restartBase * luby(i) dead
+// ends on its i-th run (restartBase 0 never restarts). The first worker to
+// find a solution, or to finish a run and so prove there is none, stops the
+// others.
+//
+// Generators must also be constructible as Generator(space, node, seed) where
+// a seed of 0 asks for the usual order and anything else for a random one.
+// Only the first run of worker 0 on locality 0 uses the usual order.
+//
+// With Nogoods, a run that is cut off learns a nogood for every subtree it
+// finished: the decisions down to the subtree's parent plus the subtree's own.
+// They are added to the NogoodStore of every locality, and each worker adds
+// whatever is new there to its own Nogoods when it restarts, so finished
+// subtrees aren't searched again while their nogoods are kept. Children that
+// fail without being expanded aren't recorded, propagation finds them as
+// quickly.
+template <typename Generator, typename ...Args>
+struct Restarts {
+  typedef typename Generator::Nodetype Node;
+  typedef typename Generator::Spacetype Space;
+
+  typedef typename API::skeleton_signature::bind<Args...>::type args;
+
+  static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+
+  typedef typename parameter::value_type<args, API::tag::Verbose_, std::integral_constant<unsigned, 0> >::type Verbose;
+  static constexpr unsigned verbose = Verbose::value;
+
+  typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
+  typedef typename boundFn::return_type Bound;
+  typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::Nogoods, API::NoNogoods>::type Nogoods;
+  static constexpr bool learnNogoods = !std::is_same<Nogoods, API::NoNogoods>::value;
+
+  // Nodes only need to provide a Decision when we learn nogoods
+  template <typename N, bool learn>
+  struct DecisionOf {
+    typedef typename N::Decision type;
+  };
+  template <typename N>
+  struct DecisionOf<N, false> {
+    typedef bool type;
+  };
+  typedef typename DecisionOf<Node, learnNogoods>::type Decision;
+  typedef std::vector<Decision> Nogood;
+
+  enum class RunResult { Found, Exhausted, CutOff, Stopped };
+
+  struct Frame {
+    Node node;
+    Generator gen;
+    unsigned seen = 0;
+    // Decisions of the children whose subtrees were searched without success
+    std::vector<Decision> refuted;
+
+    Frame(const Space & space, const Node & n, std::uint64_t seed) :
+        node(n), gen(space, node, seed) {}
+  };
+
+  static void printSkeletonDetails(const API::Params<Bound> & params) {
+    hpx::cout << "Skeleton Type: Restarts\n";
+    hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "Nogoods: " << std::boolalpha << learnNogoods << "\n";
+    hpx::cout << "Restart Base: " << params.restartBase << "\n";
+    if constexpr(learnNogoods) {
+      hpx::cout << "Nogood Limit: " << params.nogoodLimit << "\n";
+    }
+    hpx::cout << hpx::flush;
+  }
+
+  // The Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ... from i = 1
+  static std::uint64_t luby(std::uint64_t i) {
+    while (true) {
+      std::uint64_t k = 1;
+      while ((std::uint64_t{1} << k) - 1 < i) {
+        ++k;
+      }
+      if ((std::uint64_t{1} << k) - 1 == i) {
+        return std::uint64_t{1} << (k - 1);
+      }
+      i -= (std::uint64_t{1} << (k - 1)) - 1;
+    }
+  }
+
+  // Frame i's refuted children, each after the decisions leading to frame i
+  static void recordNogoods(const std::deque<Frame> & stack, std::vector<Nogood> & learned) {
+    Nogood path;
+    for (auto i = 0u; i < stack.size(); ++i) {
+      if (i > 0) {
+        path.push_back(stack[i].node.decision());
+      }
+      for (const auto & d : stack[i].refuted) {
+        auto nogood = path;
+        nogood.push_back(d);
+        learned.push_back(std::move(nogood));
+      }
+    }
+  }
+
+  static RunResult run(const Space & space,
+                       const Node & root,
+                       const API::Params<Bound> & params,
+                       std::mt19937_64 & rand,
+                       const bool usualOrder,
+                       const std::uint64_t deadEndLimit,
+                       const Nogoods & nogoods,
+                       std::vector<Nogood> & learned,
+                       Node & solution) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    auto seed = [&]() -> std::uint64_t {
+      return usualOrder ? 0 : rand() | 1;
+    };
+
+    auto start = root;
+    if (!nogoods.propagate(space, start)) {
+      return RunResult::Exhausted;
+    }
+
+    // Generators refer to the node in their frame, a deque never moves them
+    std::deque<Frame> stack;
+    stack.emplace_back(space, start, seed());
+    std::uint64_t deadEnds = 0;
+    std::uint64_t steps = 0;
+
+    while (!stack.empty()) {
+      if (reg->stopped()) {
+        return RunResult::Stopped;
+      }
+
+      // Workers never block, so let the search monitor and incoming actions
+      // (stop flags, nogoods) run now and then
+      if (++steps % 1024 == 0) {
+        hpx::this_thread::yield();
+      }
+
+      auto & top = stack.back();
+      if (top.seen == top.gen.numChildren) {
+        if constexpr(learnNogoods) {
+          if (stack.size() > 1) {
+            stack[stack.size() - 2].refuted.push_back(top.node.decision());
+          }
+        }
+        stack.pop_back();
+        continue;
+      }
+
+      auto c = top.gen.next();
+      ++top.seen;
+
+      if (countingNodes(params)) {
+        countProcessedNode<Space, Node, Bound>(params);
+      }
+
+      if (c.getObj() == params.expectedObjective) {
+        solution = c;
+        return RunResult::Found;
+      }
+
+      auto deadEnd = !nogoods.propagate(space, c);
+      if (!deadEnd) {
+        stack.emplace_back(space, c, seed());
+        if (stack.back().gen.numChildren == 0) {
+          stack.pop_back();
+          deadEnd = true;
+        }
+      }
+
+      if (deadEnd && deadEndLimit > 0 && ++deadEnds >= deadEndLimit) {
+        if constexpr(learnNogoods) {
+          if (params.nogoodLimit > 0) {
+            recordNogoods(stack, learned);
+          }
+        }
+        return RunResult::CutOff;
+      }
+    }
+
+    return RunResult::Exhausted;
+  }
+
+  static void shareNogoods(const std::vector<Nogood> & learned) {
+    if (learned.empty()) {
+      return;
+    }
+
+    NogoodStore<Space, Node>::gReg->add(learned);
+    for (const auto & l : util::findOtherLocalities()) {
+      hpx::apply<AddNogoodsAct<Space, Node> >(l, learned);
+    }
+  }
+
+  static void worker(const unsigned workerId) {
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    const auto & params = reg->params;
+    std::uint64_t locality = hpx::get_locality_id();
+
+    std::mt19937_64 rand((locality << 48) | (static_cast<std::uint64_t>(workerId) << 32));
+
+    // This worker's nogoods, oldest first. Once there are more than
+    // nogoodLimit the oldest half are dropped and the rest added again, so
+    // on average each nogood is only added a constant number of times.
+    Nogoods nogoods(reg->space);
+    std::deque<Nogood> kept;
+    std::uint64_t fetched = 0;
+
+    for (std::uint64_t i = 1; !reg->stopped(); ++i) {
+      if constexpr(learnNogoods) {
+        std::vector<Nogood> fresh;
+        fetched = NogoodStore<Space, Node>::gReg->fetch(fresh, fetched);
+        for (auto & n : fresh) {
+          nogoods.add(n);
+          kept.push_back(std::move(n));
+        }
+
+        if (kept.size() > params.nogoodLimit) {
+          kept.erase(kept.begin(), kept.end() - params.nogoodLimit / 2);
+          nogoods = Nogoods(reg->space);
+          for (const auto & n : kept) {
+            nogoods.add(n);
+          }
+        }
+      }
+
+      std::vector<Nogood> learned;
+      Node solution;
+      auto usualOrder = i == 1 && workerId == 0 && locality == 0;
+      auto res = run(reg->space, reg->root, params, rand, usualOrder,
+                     params.restartBase * luby(i), nogoods, learned, solution);
+
+      if (res == RunResult::Found) {
+        if constexpr(verbose > 1) {
+          hpx::cout <<
+            (boost::format("Found solution on: %1% (worker %2%, run %3%)\n")
+             % locality % workerId % i)
+                    << hpx::flush;
+        }
+        updateIncumbent<Space, Node, Bound, Objcmp, Verbose>(solution, solution.getObj());
+        hpx::lcos::broadcast<SetStopFlagAct<Space, Node, Bound> >(hpx::find_all_localities());
+      } else if (res == RunResult::Exhausted) {
+        if constexpr(verbose > 1) {
+          hpx::cout <<
+            (boost::format("No solution, proved on: %1% (worker %2%, run %3%)\n")
+             % locality % workerId % i)
+                    << hpx::flush;
+        }
+        hpx::lcos::broadcast<SetStopFlagAct<Space, Node, Bound> >(hpx::find_all_localities());
+      } else if (res == RunResult::CutOff) {
+        if constexpr(learnNogoods) {
+          shareNogoods(learned);
+        }
+      }
+
+      hpx::this_thread::yield();
+    }
+  }
+
+  // Run a worker on every OS thread but one (left for the search monitor and
+  // parcels) of this locality until the search stops
+  static void searchLocality() {
+    hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_normal,
+                                                  hpx::threads::thread_stacksize_huge);
+    auto threadCount = hpx::get_os_thread_count() == 1 ? 1 : hpx::get_os_thread_count() - 1;
+    std::vector<hpx::future<void> > futures;
+    for (auto w = 0u; w < threadCount; ++w) {
+      futures.push_back(hpx::async(exe, &Restarts<Generator, Args...>::worker, w));
+    }
+    hpx::wait_all(futures);
+  }
+  struct SearchLocalityAct : hpx::actions::make_action<
+    decltype(&Restarts<Generator, Args...>::searchLocality),
+    &Restarts<Generator, Args...>::searchLocality,
+    SearchLocalityAct>::type {};
+
+  static auto search (const Space & space,
+                      const Node & root,
+                      API::Params<Bound> params = API::Params<Bound>()) {
+    static_assert(isDecision, "The Restarts skeleton only supports Decision searches");
+
+    if constexpr(verbose) {
+      printSkeletonDetails(params);
+    }
+
+    hpx::wait_all(hpx::lcos::broadcast<InitRegistryAct<Space, Node, Bound> >(
+        hpx::find_all_localities(), space, root, params));
+
+    if constexpr(learnNogoods) {
+      hpx::wait_all(hpx::lcos::broadcast<InitNogoodStoreAct<Space, Node> >(
+          hpx::find_all_localities(), params.nogoodLimit));
+    }
+
+    auto inc = hpx::new_<Incumbent>(hpx::find_here()).get();
+    hpx::wait_all(hpx::lcos::broadcast<UpdateGlobalIncumbentAct<Space, Node, Bound> >(
+        hpx::find_all_localities(), inc));
+    initIncumbent<Space, Node, Bound, Objcmp, Verbose>(root, params.initialBound);
+
+    auto monitor = startSearchMonitor<Space, Node, Bound, boundFn, false, verbose>(space, root, params);
+
+    hpx::wait_all(hpx::lcos::broadcast<SearchLocalityAct>(hpx::find_all_localities()));
+
+    monitor.stop();
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      NodeCounters::printSummary();
+    }
+
+    hpx::cout << hpx::flush;
+
+    auto reg = Registry<Space, Node, Bound>::gReg;
+    typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
+    return hpx::async<getInc>(reg->globalIncumbent).get();
+  }
+};
+
+}}
+
+#endif
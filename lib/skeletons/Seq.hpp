@@ -2,14 +2,21 @@
 #define SKELETONS_SEQ_HPP
 
 #include <hpx/include/iostreams.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <vector>
 #include <cstdint>
+#include <optional>
 
 #include <boost/format.hpp>
 
 #include "API.hpp"
+#include "util/NodeCounters.hpp"
 #include "util/NodeGenerator.hpp"
 #include "util/func.hpp"
+#include "util/SolutionStore.hpp"
+#include "util/WarmStart.hpp"
 
 namespace YewPar { namespace Skeletons {
 
@@ -21,20 +28,59 @@ struct Seq {
   typedef typename API::skeleton_signature::bind<Args...>::type args;
 
   static constexpr bool isCountNodes = parameter::value_type<args, API::tag::CountNodes_, std::integral_constant<bool, false> >::type::value;
+  typedef typename parameter::value_type<args, API::tag::Enumeration, API::NoEnumeration>::type Enumerator;
+  static constexpr bool isEnumeration = !std::is_same<Enumerator, API::NoEnumeration>::value;
   static constexpr bool isBnB = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDepthBounded = parameter::value_type<args, API::tag::DepthLimited_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
   static constexpr unsigned verbose = parameter::value_type<args, API::tag::Verbose_, std::integral_constant<unsigned, 0> >::type::value;
   typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
   typedef typename boundFn::return_type Bound;
   typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::IncumbentCallback, nullFn__>::type incumbentCallback;
+  typedef typename parameter::value_type<args, API::tag::WarmStart, nullFn__>::type warmStartFn;
+
+  // Anytime search
+  struct Limits {
+    std::chrono::steady_clock::time_point startTime;
+    std::uint64_t nodes = 0;
+    Bound rootBound;
+  };
+
+  // Checked for every node so we only look at the clock occasionally
+  static bool limitReached(const API::Params<Bound> & params, Limits & limits) {
+    ++limits.nodes;
+    if (params.nodeLimit > 0 && limits.nodes >= params.nodeLimit) {
+      return true;
+    }
+    if (params.timeLimit > 0 && limits.nodes % 1024 == 0) {
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - limits.startTime);
+      return static_cast<std::uint64_t>(elapsed.count()) >= params.timeLimit;
+    }
+    return false;
+  }
+
+  static bool gapClosed(const API::Params<Bound> & params, const Limits & limits, const Bound & best) {
+    if constexpr(!std::is_same<boundFn, nullFn__>::value && std::is_arithmetic<Bound>::value) {
+      if (params.optimalityGap >= 0) {
+        return std::abs(static_cast<double>(limits.rootBound) - static_cast<double>(best)) <= params.optimalityGap;
+      }
+    }
+    return false;
+  }
 
   static void printSkeletonDetails() {
     hpx::cout << "Skeleton Type: Seq\n";
     hpx::cout << "CountNodes : " << std::boolalpha << isCountNodes << "\n";
+    hpx::cout << "Enumeration : " << std::boolalpha << isEnumeration << "\n";
     hpx::cout << "Optimisation: " << std::boolalpha << isBnB << "\n";
     hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "AllSolutions: " << std::boolalpha << isAllSolutions << "\n";
+    hpx::cout << "TopK: " << std::boolalpha << isTopK << "\n";
     hpx::cout << "DepthBounded: " << std::boolalpha << isDepthBounded << "\n";
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
       hpx::cout << "Using Bounding: true\n";
@@ -45,19 +91,36 @@ struct Seq {
     hpx::cout << hpx::flush;
   }
 
+  static void countPruned() {
+    if constexpr(NodeCounters::enabled) {
+      NodeCounters::countPruned();
+      if constexpr(pruneLevel) {
+        NodeCounters::countBroken();
+      }
+    }
+  }
+
   static bool expand(const Space & space,
                      const Node & n,
                      const API::Params<Bound> & params,
                      std::pair<Node, Bound> & incumbent,
                      const unsigned childDepth,
-                     std::vector<uint64_t> & counts) {
-    Generator newCands = Generator(space, n);
+                     std::vector<uint64_t> & counts,
+                     Enumerator & acc,
+                     Limits & limits) {
+    // Generators are given the incumbent bound (see util/NodeGenerator.hpp)
+    std::optional<Bound> genBound;
+    if constexpr(isBnB || isDecision) {
+      genBound = std::get<1>(incumbent);
+    }
+    Generator newCands = makeGenerator<Generator>(space, n, genBound);
 
     if constexpr(isCountNodes) {
         counts[childDepth] += newCands.numChildren;
     }
 
-    if constexpr(isDepthBounded) {
+    // Enumerations still visit the nodes at the depth limit (see below)
+    if constexpr(isDepthBounded && !isEnumeration) {
         if (childDepth == params.maxDepth) {
           return false;
         }
@@ -66,6 +129,16 @@ struct Seq {
     for (auto i = 0; i < newCands.numChildren; ++i) {
       auto c = newCands.next();
 
+      if constexpr(NodeCounters::enabled) {
+        NodeCounters::countProcessed();
+      }
+
+      if (params.timeLimit > 0 || params.nodeLimit > 0) {
+        if (limitReached(params, limits)) {
+          return true;
+        }
+      }
+
       if constexpr(isDecision) {
         if (c.getObj() == params.expectedObjective) {
           std::get<0>(incumbent) = c;
@@ -79,12 +152,21 @@ struct Seq {
         }
       }
 
+      // Solutions are leaves: record them and move on
+      if constexpr(isAllSolutions) {
+        if (c.getObj() == params.expectedObjective) {
+          SolutionStore<Space, Node, Bound, Objcmp>::gReg->addSolution(c);
+          continue;
+        }
+      }
+
       // Do we support bounding?
       if constexpr(!std::is_same<boundFn, nullFn__>::value) {
           Objcmp cmp;
           auto bnd  = boundFn::invoke(space, c);
-          if constexpr(isDecision) {
+          if constexpr(isDecision || isAllSolutions) {
             if (!cmp(bnd, params.expectedObjective) && bnd != params.expectedObjective) {
+              countPruned();
               if constexpr(pruneLevel) {
                 break;
               } else {
@@ -95,6 +177,7 @@ struct Seq {
           } else {
             auto best = std::get<1>(incumbent);
             if (!cmp(bnd,best)) {
+              countPruned();
               if constexpr(pruneLevel) {
                   break;
                 } else {
@@ -112,29 +195,62 @@ struct Seq {
           if constexpr(verbose >= 1) {
             hpx::cout << (boost::format("New Incumbent: %1%\n") % c.getObj()) << hpx::flush;
           }
+          if constexpr(!std::is_same<incumbentCallback, nullFn__>::value) {
+            incumbentCallback::invoke(c, c.getObj(), std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - limits.startTime));
+          }
+          if (gapClosed(params, limits, c.getObj())) {
+            return true;
+          }
         }
       }
 
-      auto found = expand(space, c, params, incumbent, childDepth + 1, counts);
-      if constexpr(isDecision) {
-        // Propagate early exit
-        if (found) {
-          return true;
+      // For TopK the incumbent bound tracks the k-th best value
+      if constexpr(isTopK) {
+        Objcmp cmp;
+        if (cmp(c.getObj(), std::get<1>(incumbent))) {
+          Bound kth;
+          if (SolutionStore<Space, Node, Bound, Objcmp>::gReg->offer(c, kth)) {
+            std::get<1>(incumbent) = kth;
+          }
         }
       }
+
+      if constexpr(isEnumeration) {
+        acc.accumulate(c);
+        if constexpr(isDepthBounded) {
+          if (childDepth == params.maxDepth) {
+            continue;
+          }
+        }
+      }
+
+      auto found = expand(space, c, params, incumbent, childDepth + 1, counts, acc, limits);
+      // Propagate early exit (solution found or anytime limit reached)
+      if (found) {
+        return true;
+      }
     }
     return false;
   }
 
   static auto search (const Space & space,
                       const Node & root,
-                      const API::Params<Bound> params = API::Params<Bound>()) {
-    static_assert(isCountNodes || isBnB || isDecision, "Please provide a supported search type: CountNodes, BnB, Decision");
+                      API::Params<Bound> params = API::Params<Bound>()) {
+    static_assert(isCountNodes || isEnumeration || isBnB || isDecision || isAllSolutions || isTopK, "Please provide a supported search type: CountNodes, Enumeration, BnB, Decision, AllSolutions, TopK");
+    static_assert(!(isCountNodes && isEnumeration), "CountNodes and Enumeration can't be combined, count within the Enumeration instead");
 
     if constexpr (verbose) {
       printSkeletonDetails();
     }
 
+    // Seeds the incumbent (and raises params.initialBound) if we have a
+    // warm start heuristic
+    auto start = root;
+    if constexpr(isBnB) {
+      start = warmStart<Space, Node, Bound, Objcmp, warmStartFn>(space, root, params);
+    }
+
     std::vector<std::uint64_t> counts;
 
     if constexpr(isCountNodes) {
@@ -142,10 +258,48 @@ struct Seq {
       counts[0] = 1;
     }
 
-    std::pair<Node, Bound> incumbent = std::make_pair(root, params.initialBound);
-    expand(space, root, params, incumbent, 1, counts);
+    Limits limits;
+    limits.startTime = std::chrono::steady_clock::now();
+    if constexpr(isBnB && !std::is_same<boundFn, nullFn__>::value) {
+      if (params.optimalityGap >= 0) {
+        limits.rootBound = boundFn::invoke(space, root);
+      }
+    }
 
-    if constexpr(isCountNodes && (isBnB || isDecision)) {
+    Enumerator acc;
+    if constexpr(isEnumeration) {
+      acc.accumulate(root);
+    }
+
+    if constexpr(isAllSolutions || isTopK) {
+      SolutionStore<Space, Node, Bound, Objcmp>::gReg->initialise(params);
+    }
+
+    auto countersBefore = NodeCounters::localTotals();
+
+    std::pair<Node, Bound> incumbent = std::make_pair(start, params.initialBound);
+    expand(space, root, params, incumbent, 1, counts, acc, limits);
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      auto countersAfter = NodeCounters::localTotals();
+      hpx::cout << (boost::format("Nodes processed: %1%, pruned: %2%, levels broken: %3%\n")
+                    % (countersAfter.processed - countersBefore.processed)
+                    % (countersAfter.pruned - countersBefore.pruned)
+                    % (countersAfter.broken - countersBefore.broken)) << hpx::flush;
+    }
+
+    if constexpr(isEnumeration) {
+      return acc;
+    } else if constexpr(isAllSolutions || isTopK) {
+      auto sols = SolutionStore<Space, Node, Bound, Objcmp>::gReg->getSolutions();
+      if constexpr(isTopK) {
+        std::sort(sols.begin(), sols.end(), [](const Node & a, const Node & b) {
+            Objcmp cmp;
+            return cmp(a.getObj(), b.getObj());
+          });
+      }
+      return sols;
+    } else if constexpr(isCountNodes && (isBnB || isDecision)) {
         return std::make_pair(std::get<0>(incumbent), counts);
     } else if constexpr(isCountNodes) {
       return counts;
@@ -35,8 +35,12 @@ struct StackStealing {
   typedef typename API::skeleton_signature::bind<Args...>::type args;
 
   static constexpr bool isCountNodes = parameter::value_type<args, API::tag::CountNodes_, std::integral_constant<bool, false> >::type::value;
+  typedef typename parameter::value_type<args, API::tag::Enumeration, API::NoEnumeration>::type Enumerator;
+  static constexpr bool isEnumeration = !std::is_same<Enumerator, API::NoEnumeration>::value;
   static constexpr bool isOptimisation = parameter::value_type<args, API::tag::Optimisation_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDecision = parameter::value_type<args, API::tag::Decision_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isAllSolutions = parameter::value_type<args, API::tag::AllSolutions_, std::integral_constant<bool, false> >::type::value;
+  static constexpr bool isTopK = parameter::value_type<args, API::tag::TopK_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool isDepthBounded = parameter::value_type<args, API::tag::DepthLimited_, std::integral_constant<bool, false> >::type::value;
   static constexpr bool pruneLevel = parameter::value_type<args, API::tag::PruneLevel_, std::integral_constant<bool, false> >::type::value;
   static constexpr unsigned maxStackDepth = parameter::value_type<args, API::tag::MaxStackDepth, std::integral_constant<unsigned, 5000> >::type::value;
@@ -47,12 +51,17 @@ struct StackStealing {
   typedef typename parameter::value_type<args, API::tag::BoundFunction, nullFn__>::type boundFn;
   typedef typename boundFn::return_type Bound;
   typedef typename parameter::value_type<args, API::tag::ObjectiveComparison, std::greater<Bound> >::type Objcmp;
+  typedef typename parameter::value_type<args, API::tag::IncumbentCallback, nullFn__>::type incumbentCallback;
+  typedef typename parameter::value_type<args, API::tag::WarmStart, nullFn__>::type warmStartFn;
 
   static void printSkeletonDetails(const API::Params<Bound> & params) {
     hpx::cout << "Skeleton Type: StackStealing\n";
     hpx::cout << "CountNodes : " << std::boolalpha << isCountNodes << "\n";
+    hpx::cout << "Enumeration : " << std::boolalpha << isEnumeration << "\n";
     hpx::cout << "Optimisation: " << std::boolalpha << isOptimisation << "\n";
     hpx::cout << "Decision: " << std::boolalpha << isDecision << "\n";
+    hpx::cout << "AllSolutions: " << std::boolalpha << isAllSolutions << "\n";
+    hpx::cout << "TopK: " << std::boolalpha << isTopK << "\n";
     hpx::cout << "DepthBounded: " << std::boolalpha << isDepthBounded << "\n";
     hpx::cout << "MaxStackDepth: " << maxStackDepth << "\n";
     if constexpr(!std::is_same<boundFn, nullFn__>::value) {
@@ -72,7 +81,7 @@ struct StackStealing {
     std::vector<std::uint64_t> cntMap;
 
     // Setup the stack with root node
-    StackElem<Generator> rootElem(reg->space, initNode);
+    StackElem<Generator> rootElem(reg->space, initNode, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
 
     GeneratorStack<Generator> generatorStack(maxStackDepth, rootElem);
     if constexpr (isCountNodes) {
@@ -83,12 +92,18 @@ struct StackStealing {
       cntMap[depth] += rootElem.gen.numChildren;
     }
 
+    // Stolen/spawned nodes are accumulated by whoever runs them
+    Enumerator acc;
+    if constexpr (isEnumeration) {
+      acc.accumulate(initNode);
+    }
+
     // Register with the Policy to allow stealing from this stack
     std::shared_ptr<SharedState> stealReq;
     unsigned threadId;
     std::tie(stealReq, threadId) = std::static_pointer_cast<Policy>(Workstealing::Scheduler::local_policy)->registerThread();
 
-    runTaskFromStack(depth, reg->space, generatorStack, stealReq, cntMap, donePromise, threadId);
+    runTaskFromStack(depth, reg->space, generatorStack, stealReq, cntMap, acc, donePromise, threadId);
   }
 
   using SubTreeTask = func<
@@ -129,6 +144,7 @@ struct StackStealing {
                            GeneratorStack<Generator> & generatorStack,
                            std::shared_ptr<SharedState> stealRequest,
                            std::vector<std::uint64_t> & cntMap,
+                           Enumerator & acc,
                            std::vector<hpx::future<void> > & futures,
                            int stackDepth = 0,
                            int depth = -1) {
@@ -142,10 +158,8 @@ struct StackStealing {
 
     while (stackDepth >= 0) {
 
-      if constexpr(isDecision) {
-        if (reg->stopSearch) {
-          return;
-        }
+      if (reg->stopped()) {
+        return;
       }
 
       // Handle steals first
@@ -215,8 +229,18 @@ struct StackStealing {
           continue;
         }
 
+        if constexpr(isEnumeration) {
+          acc.accumulate(child);
+          // The child is at the depth limit, enumerate it but don't go down
+          if constexpr(isDepthBounded) {
+            if (depth == reg->params.maxDepth) {
+              continue;
+            }
+          }
+        }
+
         // Get the child's generator
-        const auto childGen = Generator(space, child);
+        const auto childGen = makeGenerator<Generator>(space, child, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
 
         // Going down
         stackDepth++;
@@ -226,7 +250,7 @@ struct StackStealing {
             cntMap[depth] += childGen.numChildren;
         }
 
-        if constexpr(isDepthBounded) {
+        if constexpr(isDepthBounded && !isEnumeration) {
             // This doesn't look quite right to me, we want the next element at this level not the previous?
             if (depth == reg->params.maxDepth) {
               stackDepth--;
@@ -250,6 +274,7 @@ struct StackStealing {
                                 GeneratorStack<Generator> & generatorStack,
                                 const std::shared_ptr<SharedState> stealRequest,
                                 std::vector<std::uint64_t> & cntMap,
+                                Enumerator & acc,
                                 const hpx::naming::id_type donePromise,
                                 const unsigned searchManagerId,
                                 const int stackDepth = 0,
@@ -257,13 +282,17 @@ struct StackStealing {
     auto reg = Registry<Space, Node, Bound>::gReg;
     std::vector<hpx::future<void> > futures;
 
-    runWithStack(startingDepth, space, generatorStack, stealRequest, cntMap, futures, stackDepth, depth);
+    runWithStack(startingDepth, space, generatorStack, stealRequest, cntMap, acc, futures, stackDepth, depth);
 
     // Atomically updates the (process) local counter
     if constexpr(isCountNodes) {
         reg->updateCounts(cntMap);
     }
 
+    if constexpr(isEnumeration) {
+      EnumRegistry<Space, Node, Enumerator>::gReg->combine(acc);
+    }
+
     std::static_pointer_cast<Policy>(Workstealing::Scheduler::local_policy)->unregisterThread(searchManagerId);
 
     hpx::apply(hpx::util::bind([=](std::vector<hpx::future<void> > & futs) {
@@ -296,6 +325,7 @@ struct StackStealing {
                                const Space & space,
                                GeneratorStack<Generator> & generatorStack,
                                std::vector<std::uint64_t> & countMap,
+                               Enumerator & acc,
                                std::vector<hpx::future<void> > & futures){
     auto localities = util::findOtherLocalities();
     localities.push_back(hpx::find_here());
@@ -335,8 +365,12 @@ struct StackStealing {
             break;
           }
         } else {
+          if constexpr(isEnumeration) {
+            acc.accumulate(child);
+          }
+
           // Get the child's generator
-          const auto childGen = Generator(space, child);
+          const auto childGen = makeGenerator<Generator>(space, child, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
           if constexpr(isCountNodes) {
               countMap[depth] += childGen.numChildren;
           }
@@ -364,7 +398,7 @@ struct StackStealing {
     }
 
     // Master stack
-    StackElem<Generator> rootElem(space, root);
+    StackElem<Generator> rootElem(space, root, generatorBound<Space, Node, Bound, isOptimisation || isDecision>());
     // rootElem.seen = 0;
     // rootElem.node = root;
     // rootElem.gen = Generator(space, rootElem.node);
@@ -377,13 +411,18 @@ struct StackStealing {
         countMap[1] += rootElem.gen.numChildren;
     }
 
+    Enumerator acc;
+    if constexpr (isEnumeration) {
+      acc.accumulate(root);
+    }
+
     auto stackDepth = 0;
     auto depth = 1;
 
     std::vector<hpx::future<void> > futures;
     if (totalThreads > 1) {
       auto depthRequired = getRequiredSpawnDepth(space, root, params, totalThreads);
-      spawnInitialWork(depthRequired, totalThreads - 1, stackDepth, depth, space, genStack, countMap, futures);
+      spawnInitialWork(depthRequired, totalThreads - 1, stackDepth, depth, space, genStack, countMap, acc, futures);
     }
 
     // Register the rest of the work from the main thread with the search manager
@@ -397,11 +436,11 @@ struct StackStealing {
 
     // Launch initialising thread as a new Scheduler
     if (totalThreads == 1) {
-      runTaskFromStack(1, space, genStack, stealRequest, countMap, pid, std::get<1>(searchMgrInfo), stackDepth, depth);
+      runTaskFromStack(1, space, genStack, stealRequest, countMap, acc, pid, std::get<1>(searchMgrInfo), stackDepth, depth);
     } else {
       hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_critical,
                                                     hpx::threads::thread_stacksize_huge);
-      hpx::util::function<void(), false> fn = hpx::util::bind(&runTaskFromStack, 1, space, genStack, stealRequest, countMap, pid, std::get<1>(searchMgrInfo), stackDepth, depth);
+      hpx::util::function<void(), false> fn = hpx::util::bind(&runTaskFromStack, 1, space, genStack, stealRequest, countMap, acc, pid, std::get<1>(searchMgrInfo), stackDepth, depth);
       auto f = hpx::util::bind(&Workstealing::Scheduler::scheduler, fn);
       exe.add(f);
     }
@@ -412,28 +451,60 @@ struct StackStealing {
 
   static auto search (const Space & space,
                       const Node & root,
-                      const API::Params<Bound> params = API::Params<Bound>()) {
+                      API::Params<Bound> params = API::Params<Bound>()) {
+    static_assert(!(isCountNodes && isEnumeration), "CountNodes and Enumeration can't be combined, count within the Enumeration instead");
+
     if constexpr(verbose) {
       printSkeletonDetails(params);
     }
 
+    // Seeds the incumbent (and raises params.initialBound) if we have a
+    // warm start heuristic
+    auto start = root;
+    if constexpr(isOptimisation) {
+      start = warmStart<Space, Node, Bound, Objcmp, warmStartFn>(space, root, params);
+    }
+
     hpx::wait_all(hpx::lcos::broadcast<InitRegistryAct<Space, Node, Bound> >(
         hpx::find_all_localities(), space, root, params));
 
+    if constexpr(isAllSolutions || isTopK) {
+      hpx::wait_all(hpx::lcos::broadcast<InitSolutionStoreAct<Space, Node, Bound, Objcmp> >(
+          hpx::find_all_localities(), params));
+    }
+
+    if constexpr(isEnumeration) {
+      hpx::wait_all(hpx::lcos::broadcast<InitEnumRegistryAct<Space, Node, Enumerator> >(
+          hpx::find_all_localities()));
+    }
+
     Policy::initPolicy();
 
     if constexpr(isOptimisation || isDecision) {
       auto inc = hpx::new_<Incumbent>(hpx::find_here()).get();
       hpx::wait_all(hpx::lcos::broadcast<UpdateGlobalIncumbentAct<Space, Node, Bound> >(
           hpx::find_all_localities(), inc));
-      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(root, params.initialBound);
+      initIncumbent<Space, Node, Bound, Objcmp, Verbose>(start, params.initialBound);
+      setIncumbentCallback<Space, Node, Bound, Objcmp, Verbose, incumbentCallback>();
     }
 
+    auto monitor = startSearchMonitor<Space, Node, Bound, boundFn, isOptimisation, verbose>(space, root, params);
+
     doSearch(space, root, params);
 
     hpx::wait_all(hpx::lcos::broadcast<Workstealing::Scheduler::stopSchedulers_act>(
         hpx::find_all_localities()));
 
+    monitor.stop();
+
+    if (!params.traceFile.empty()) {
+      Trace::writeChromeTrace(params.traceFile);
+    }
+
+    if constexpr(verbose >= 1 && NodeCounters::enabled) {
+      NodeCounters::printSummary();
+    }
+
     hpx::cout << hpx::flush;
 
     if (verbose >= 3) {
@@ -446,13 +517,17 @@ struct StackStealing {
     // Return the right thing
     if constexpr(isCountNodes) {
       return totalNodeCounts<Space, Node, Bound>(params.maxDepth);
+    } else if constexpr(isEnumeration) {
+      return totalEnumeration<Space, Node, Enumerator>();
+    } else if constexpr(isAllSolutions || isTopK) {
+      return collectSolutions<Space, Node, Bound, Objcmp, isTopK>(params);
     } else if constexpr(isOptimisation || isDecision) {
       auto reg = Registry<Space, Node, Bound>::gReg;
 
       typedef typename Incumbent::GetIncumbentAct<Node, Bound, Objcmp, Verbose> getInc;
       return hpx::async<getInc>(reg->globalIncumbent).get();
     } else {
-      static_assert(isCountNodes || isOptimisation || isDecision, "Please provide a supported search type: CountNodes, Optimisation, Decision");
+      static_assert(isCountNodes || isEnumeration || isOptimisation || isDecision || isAllSolutions || isTopK, "Please provide a supported search type: CountNodes, Enumeration, Optimisation, Decision, AllSolutions, TopK");
     }
   }
 };
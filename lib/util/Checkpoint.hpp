@@ -0,0 +1,224 @@
+#ifndef YEWPAR_CHECKPOINT_HPP
+#define YEWPAR_CHECKPOINT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <hpx/include/async.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/broadcast.hpp>
+#include <hpx/lcos/local/mutex.hpp>
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/traits/action_stacksize.hpp>
+
+#include "skeletons/API.hpp"
+
+namespace YewPar {
+
+// A task is identified by the child indices taken from the root to reach it,
+// i.e. the node is recovered by repeated NodeGenerator::nth calls. This keeps
+// checkpoints small and independent of the node type.
+using TaskPath = std::vector<unsigned>;
+
+// Finished work as seen by one locality (or all, once merged)
+struct CheckpointData {
+  std::vector<TaskPath> done;
+  std::vector<std::uint64_t> counts;
+
+  void merge(const CheckpointData & other) {
+    done.insert(done.end(), other.done.begin(), other.done.end());
+    if (counts.size() < other.counts.size()) {
+      counts.resize(other.counts.size());
+    }
+    for (auto i = 0; i < other.counts.size(); ++i) {
+      counts[i] += other.counts[i];
+    }
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & done;
+    ar & counts;
+  }
+};
+
+// On disk format
+template <typename Node>
+struct Checkpoint {
+  // Paths are only meaningful for the same spawn depth
+  unsigned spawnDepth;
+  CheckpointData data;
+  bool hasIncumbent = false;
+  Node incumbent;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & spawnDepth;
+    ar & data;
+    ar & hasIncumbent;
+    ar & incumbent;
+  }
+};
+
+// Write to a temporary file first so a failure mid-write never destroys the
+// previous checkpoint
+template <typename Node>
+void writeCheckpointFile(const std::string & fileName, const Checkpoint<Node> & cp) {
+  std::vector<char> data;
+  {
+    hpx::serialization::output_archive oa(data);
+    oa << cp;
+  }
+
+  auto tmp = fileName + ".tmp";
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    f.write(data.data(), data.size());
+  }
+  std::rename(tmp.c_str(), fileName.c_str());
+}
+
+template <typename Node>
+Checkpoint<Node> readCheckpointFile(const std::string & fileName) {
+  std::ifstream f(fileName, std::ios::binary);
+  if (!f) {
+    throw std::runtime_error("Could not open checkpoint file: " + fileName);
+  }
+  std::vector<char> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+  Checkpoint<Node> cp;
+  hpx::serialization::input_archive ia(data, data.size());
+  ia >> cp;
+  return cp;
+}
+
+// Per-locality record of the tasks that have finished (along with the nodes
+// they counted) and, when restarting, the tasks that can be skipped.
+template <typename Space, typename Node, typename Bound>
+struct CheckpointRegistry {
+  static CheckpointRegistry<Space, Node, Bound>* gReg;
+
+  using mutex_t = hpx::lcos::local::mutex;
+  mutex_t mtx;
+
+  CheckpointData finished;
+  std::set<TaskPath> skip;
+
+  void initialise(std::vector<TaskPath> skipPaths) {
+    finished = CheckpointData();
+    skip = std::set<TaskPath>(skipPaths.begin(), skipPaths.end());
+  }
+
+  // Only valid for tasks whose entire subtree has been explored
+  void taskDone(const TaskPath & path, const std::vector<std::uint64_t> & counts) {
+    std::lock_guard<mutex_t> l(mtx);
+    finished.done.push_back(path);
+    if (finished.counts.size() < counts.size()) {
+      finished.counts.resize(counts.size());
+    }
+    for (auto i = 0; i < counts.size(); ++i) {
+      finished.counts[i] += counts[i];
+    }
+  }
+
+  // Carry forward the work finished before a restart
+  void restore(const CheckpointData & data) {
+    std::lock_guard<mutex_t> l(mtx);
+    finished.merge(data);
+  }
+
+  // skip is read-only during the search so needs no lock
+  bool shouldSkip(const TaskPath & path) const {
+    return !skip.empty() && skip.find(path) != skip.end();
+  }
+
+  CheckpointData get() {
+    std::lock_guard<mutex_t> l(mtx);
+    return finished;
+  }
+};
+
+template <typename Space, typename Node, typename Bound>
+CheckpointRegistry<Space, Node, Bound>* CheckpointRegistry<Space, Node, Bound>::gReg = new CheckpointRegistry<Space, Node, Bound>;
+
+template <typename Space, typename Node, typename Bound>
+void initialiseCheckpointRegistry(std::vector<TaskPath> skip) {
+  CheckpointRegistry<Space, Node, Bound>::gReg->initialise(skip);
+}
+template <typename Space, typename Node, typename Bound>
+struct InitCheckpointRegistryAct : hpx::actions::make_direct_action<
+  decltype(&initialiseCheckpointRegistry<Space, Node, Bound>), &initialiseCheckpointRegistry<Space, Node, Bound>, InitCheckpointRegistryAct<Space, Node, Bound> >::type {};
+
+template <typename Space, typename Node, typename Bound>
+CheckpointData getCheckpointData() {
+  return CheckpointRegistry<Space, Node, Bound>::gReg->get();
+}
+template <typename Space, typename Node, typename Bound>
+struct GetCheckpointDataAct : hpx::actions::make_direct_action<
+  decltype(&getCheckpointData<Space, Node, Bound>), &getCheckpointData<Space, Node, Bound>, GetCheckpointDataAct<Space, Node, Bound> >::type {};
+
+// Periodically calls write on the master locality, in the same way as the
+// SearchMonitor
+class CheckpointWriter {
+ private:
+  std::shared_ptr<std::atomic<bool> > done;
+  hpx::future<void> writer;
+
+ public:
+  void start(const unsigned intervalSeconds, std::function<void()> write) {
+    done = std::make_shared<std::atomic<bool> >(false);
+
+    auto finished = done;
+    hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_high);
+    writer = hpx::async(exe, [=]() {
+        auto last = std::chrono::steady_clock::now();
+        while (!*finished) {
+          // Poll rather than sleeping the full interval so stop() returns quickly
+          hpx::this_thread::sleep_for(std::chrono::milliseconds(100));
+          if (std::chrono::steady_clock::now() - last >= std::chrono::seconds(intervalSeconds)) {
+            write();
+            last = std::chrono::steady_clock::now();
+          }
+        }
+      });
+  }
+
+  void stop() {
+    if (done) {
+      *done = true;
+      writer.get();
+      done.reset();
+    }
+  }
+};
+
+} // YewPar
+
+namespace hpx { namespace traits {
+
+template <typename Space, typename Node, typename Bound>
+struct action_stacksize<YewPar::InitCheckpointRegistryAct<Space, Node, Bound> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+template <typename Space, typename Node, typename Bound>
+struct action_stacksize<YewPar::GetCheckpointDataAct<Space, Node, Bound> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+}}
+
+#endif
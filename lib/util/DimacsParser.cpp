@@ -0,0 +1,191 @@
+#include "DimacsParser.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "MappedFile.hpp"
+
+namespace YewPar { namespace util {
+
+CSRGraph csrFromEdges(unsigned size, const std::vector<std::pair<unsigned, unsigned> > & edges) {
+  CSRGraph g;
+  g.size = size;
+
+  // Count degrees (shifted by one so the prefix sum gives the offsets)
+  g.offsets.assign(size + 1, 0);
+  for (const auto & e : edges) {
+    ++g.offsets[e.first + 1];
+    if (e.first != e.second) {
+      ++g.offsets[e.second + 1];
+    }
+  }
+  std::partial_sum(g.offsets.begin(), g.offsets.end(), g.offsets.begin());
+
+  g.neighbours.resize(g.offsets[size]);
+  std::vector<std::size_t> next(g.offsets.begin(), g.offsets.end() - 1);
+  for (const auto & e : edges) {
+    g.neighbours[next[e.first]++] = e.second;
+    if (e.first != e.second) {
+      g.neighbours[next[e.second]++] = e.first;
+    }
+  }
+
+  // Sort each list and drop duplicate edges, compacting as we go
+  std::size_t out = 0;
+  std::size_t start = 0;
+  for (unsigned v = 0; v < size; ++v) {
+    auto first = g.neighbours.begin() + start;
+    auto last  = g.neighbours.begin() + g.offsets[v + 1];
+    std::sort(first, last);
+    auto uniqueEnd = std::unique(first, last);
+    start = g.offsets[v + 1];
+    out = std::move(first, uniqueEnd, g.neighbours.begin() + out) - g.neighbours.begin();
+    g.offsets[v + 1] = out;
+  }
+  g.neighbours.resize(out);
+
+  return g;
+}
+
+namespace {
+
+// Cursor over the mapped file. Lines end at '\n' or the end of the file.
+struct Scanner {
+  const char * p;
+  const char * end;
+
+  bool atEndOfLine() const {
+    return p == end || *p == '\n';
+  }
+
+  bool atSpace() const {
+    return p != end && (*p == ' ' || *p == '\t' || *p == '\r');
+  }
+
+  void skipSpace() {
+    while (atSpace()) {
+      ++p;
+    }
+  }
+
+  void skipLine() {
+    while (p != end && *p != '\n') {
+      ++p;
+    }
+  }
+
+  bool readNumber(unsigned long & n) {
+    skipSpace();
+    if (p == end || *p < '0' || *p > '9') {
+      return false;
+    }
+    n = 0;
+    while (p != end && *p >= '0' && *p <= '9') {
+      // Anything this big is out of bounds anyway, just don't wrap around
+      n = std::min(n * 10 + (*p - '0'), 1UL << 48);
+      ++p;
+    }
+    return true;
+  }
+
+  bool readWord(const std::string & w) {
+    skipSpace();
+    if (static_cast<std::size_t>(end - p) < w.size() || !std::equal(w.begin(), w.end(), p)) {
+      return false;
+    }
+    p += w.size();
+    return atSpace() || atEndOfLine();
+  }
+};
+
+std::string lineAt(const char * start, const char * end) {
+  return std::string(start, std::find(start, end, '\n'));
+}
+
+}
+
+CSRGraph readDimacs(const std::string & filename) {
+  MappedFile file(filename);
+
+  unsigned long size = 0;
+  bool seenProblem = false;
+  std::vector<std::pair<unsigned, unsigned> > edges;
+
+  Scanner s {file.begin(), file.end()};
+  while (s.p != s.end) {
+    auto lineStart = s.p;
+    auto malformed = [&]() {
+      return std::runtime_error("cannot parse line '" + lineAt(lineStart, s.end) + "'");
+    };
+
+    /* Lines are comments, a problem description (contains the number of
+     * vertices), or an edge. */
+    switch (*s.p) {
+      case '\n':
+      case '\r':
+        break;
+      case 'c':
+        ++s.p;
+        if (!s.atSpace() && !s.atEndOfLine()) {
+          throw malformed();
+        }
+        break;
+      case 'p': {
+        /* Problem. Specifies the size of the graph. Must happen exactly
+         * once. */
+        ++s.p;
+        if (!s.atSpace() || (!s.readWord("edge") && !s.readWord("col"))) {
+          throw malformed();
+        }
+        unsigned long nEdges = 0;
+        if (!s.readNumber(size) || size > std::numeric_limits<unsigned>::max()) {
+          throw malformed();
+        }
+        s.readNumber(nEdges);
+        s.skipSpace();
+        if (!s.atEndOfLine()) {
+          throw malformed();
+        }
+        if (seenProblem) {
+          throw std::runtime_error("multiple 'p' lines encountered");
+        }
+        seenProblem = true;
+        // Every edge line takes at least six bytes, don't trust the header
+        // beyond that
+        edges.reserve(std::min(nEdges, file.size() / 6));
+        break;
+      }
+      case 'e': {
+        /* An edge. DIMACS files are 1-indexed. We assume we've already had
+         * a problem line (if not our size will be 0, so we'll throw). */
+        ++s.p;
+        unsigned long a, b;
+        if (!s.atSpace() || !s.readNumber(a) || !s.readNumber(b)) {
+          throw malformed();
+        }
+        s.skipSpace();
+        if (!s.atEndOfLine()) {
+          throw malformed();
+        }
+        if (0 == a || 0 == b || a > size || b > size) {
+          throw std::runtime_error("line '" + lineAt(lineStart, s.end) + "' edge index out of bounds");
+        }
+        edges.emplace_back(a - 1, b - 1);
+        break;
+      }
+      default:
+        throw malformed();
+    }
+
+    s.skipLine();
+    if (s.p != s.end) {
+      ++s.p;
+    }
+  }
+
+  return csrFromEdges(size, edges);
+}
+
+}}
@@ -0,0 +1,35 @@
+#ifndef YEWPAR_DIMACSPARSER_HPP
+#define YEWPAR_DIMACSPARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace YewPar { namespace util {
+
+// Undirected graph in compressed sparse row form. The neighbours of v are
+// neighbours[offsets[v]] up to (not including) neighbours[offsets[v + 1]],
+// sorted and without duplicates. A loop shows up as v being its own neighbour.
+struct CSRGraph {
+  unsigned size = 0;
+  std::vector<std::size_t> offsets;
+  std::vector<unsigned> neighbours;
+
+  unsigned degree(unsigned v) const {
+    return offsets[v + 1] - offsets[v];
+  }
+};
+
+// Build a CSRGraph on vertices 0..size-1 from a list of (undirected) edges,
+// which may contain duplicates
+CSRGraph csrFromEdges(unsigned size, const std::vector<std::pair<unsigned, unsigned> > & edges);
+
+// Read a DIMACS (edge or col) format file. The file is mmapped and tokenised
+// by hand, vertices are renumbered from 0. Throws std::runtime_error on a
+// malformed file.
+CSRGraph readDimacs(const std::string & filename);
+
+}}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef YEWPAR_ENUMREGISTRY_HPP
+#define YEWPAR_ENUMREGISTRY_HPP
+
+#include <vector>
+
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/get_os_thread_count.hpp>
+#include <hpx/runtime/get_worker_thread_num.hpp>
+#include <hpx/traits/action_stacksize.hpp>
+
+namespace YewPar {
+
+// Per-locality storage for Enumeration searches. Tasks fold into a local
+// accumulator and merge it into the slot of the worker they finish on, so
+// workers never contend. Slots are only combined when the result is requested
+// at the end of the search.
+template <typename Space, typename Node, typename Enum>
+struct EnumRegistry {
+  static EnumRegistry<Space, Node, Enum>* gReg;
+
+  // Keep each worker's accumulator on its own cache line
+  struct alignas(64) Slot {
+    Enum acc;
+  };
+  std::vector<Slot> slots;
+
+  void initialise() {
+    // Last slot is shared by any non-worker threads
+    slots = std::vector<Slot>(hpx::get_os_thread_count() + 1);
+  }
+
+  // No locking: an HPX thread can't be suspended mid-combine so nothing else
+  // can touch this worker's slot while we do.
+  void combine(const Enum & e) {
+    auto worker = hpx::get_worker_thread_num();
+    auto & slot = worker < slots.size() - 1 ? slots[worker] : slots.back();
+    slot.acc.combine(e);
+  }
+
+  Enum get() {
+    Enum res;
+    for (const auto & s : slots) {
+      res.combine(s.acc);
+    }
+    return res;
+  }
+};
+
+template <typename Space, typename Node, typename Enum>
+EnumRegistry<Space, Node, Enum>* EnumRegistry<Space, Node, Enum>::gReg = new EnumRegistry<Space, Node, Enum>;
+
+template <typename Space, typename Node, typename Enum>
+void initialiseEnumRegistry() {
+  EnumRegistry<Space, Node, Enum>::gReg->initialise();
+}
+template <typename Space, typename Node, typename Enum>
+struct InitEnumRegistryAct : hpx::actions::make_direct_action<
+  decltype(&initialiseEnumRegistry<Space, Node, Enum>), &initialiseEnumRegistry<Space, Node, Enum>, InitEnumRegistryAct<Space, Node, Enum> >::type {};
+
+template <typename Space, typename Node, typename Enum>
+Enum getEnumerator() {
+  return EnumRegistry<Space, Node, Enum>::gReg->get();
+}
+template <typename Space, typename Node, typename Enum>
+struct GetEnumeratorAct : hpx::actions::make_direct_action<
+  decltype(&getEnumerator<Space, Node, Enum>), &getEnumerator<Space, Node, Enum>, GetEnumeratorAct<Space, Node, Enum> >::type {};
+
+// Reduction operator for combining the results of each locality
+template <typename Enum>
+struct CombineEnumerators {
+  Enum operator()(Enum a, const Enum & b) const {
+    a.combine(b);
+    return a;
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {}
+};
+
+} // YewPar
+
+namespace hpx { namespace traits {
+
+template <typename Space, typename Node, typename Enum>
+struct action_stacksize<YewPar::InitEnumRegistryAct<Space, Node, Enum> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+template <typename Space, typename Node, typename Enum>
+struct action_stacksize<YewPar::GetEnumeratorAct<Space, Node, Enum> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+}}
+
+#endif
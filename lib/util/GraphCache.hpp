@@ -0,0 +1,206 @@
+#ifndef YEWPAR_GRAPHCACHE_HPP
+#define YEWPAR_GRAPHCACHE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.hpp"
+
+namespace YewPar { namespace util {
+
+// On-disk cache of a preprocessed graph (vertex orderings, bitset rows,
+// degrees, ...) so repeated runs on the same instance skip parsing and
+// preprocessing. A cache file is a header, a table of sections, then the
+// sections themselves: arrays of trivially copyable values, each starting on
+// a 64 byte boundary so they can be used in place once the file is mapped.
+//
+// A cache is only valid for the key it was written with. Applications build
+// the key from fileStamp of their inputs and anything else the layout depends
+// on (word counts, SIMD width), so a stale or foreign cache is just rebuilt.
+
+static constexpr std::uint32_t graphCacheVersion = 1;
+static constexpr std::uint64_t graphCacheAlignment = 64;
+
+struct GraphCacheHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t numSections;
+  std::uint64_t key;
+};
+
+struct GraphCacheSection {
+  std::uint64_t offset;
+  std::uint64_t bytes;
+};
+
+// FNV-1a over the tag then each value
+inline std::uint64_t cacheKey(const std::string & tag, std::initializer_list<std::uint64_t> values) {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  auto mix = [&](std::uint64_t v, unsigned bytes) {
+    for (auto i = 0u; i < bytes; ++i) {
+      h ^= (v >> (8 * i)) & 0xff;
+      h *= 0x100000001b3ULL;
+    }
+  };
+  for (auto c : tag) {
+    mix(static_cast<unsigned char>(c), 1);
+  }
+  for (auto v : values) {
+    mix(v, 8);
+  }
+  return h;
+}
+
+// Identifies a version of an input file by its name, size and modification
+// time
+inline std::uint64_t fileStamp(const std::string & path) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+  return cacheKey(path, {static_cast<std::uint64_t>(st.st_size),
+                         static_cast<std::uint64_t>(st.st_mtim.tv_sec),
+                         static_cast<std::uint64_t>(st.st_mtim.tv_nsec)});
+}
+
+class GraphCacheWriter {
+ private:
+  struct Section {
+    const char * data;
+    std::size_t bytes;
+  };
+  std::vector<Section> sections;
+
+  static std::uint64_t aligned(std::uint64_t offset) {
+    return (offset + graphCacheAlignment - 1) / graphCacheAlignment * graphCacheAlignment;
+  }
+
+ public:
+  // The data is only read by write, so must stay alive until then
+  template <typename T>
+  void add(const T * data, std::size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Graph cache sections must be trivially copyable");
+    sections.push_back({reinterpret_cast<const char *>(data), count * sizeof(T)});
+  }
+
+  template <typename T>
+  void add(const std::vector<T> & values) {
+    add(values.data(), values.size());
+  }
+
+  // Writes to a temporary file that is renamed into place, so concurrent runs
+  // never map a partial cache. Returns false if the cache couldn't be written.
+  bool write(const std::string & path, std::uint64_t key) const {
+    GraphCacheHeader header;
+    std::memcpy(header.magic, "YPGRAPH", sizeof(header.magic));
+    header.version = graphCacheVersion;
+    header.numSections = sections.size();
+    header.key = key;
+
+    std::vector<GraphCacheSection> table;
+    auto offset = aligned(sizeof(header) + sections.size() * sizeof(GraphCacheSection));
+    for (const auto & s : sections) {
+      table.push_back({offset, s.bytes});
+      offset = aligned(offset + s.bytes);
+    }
+
+    auto tmp = path + ".tmp" + std::to_string(::getpid());
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(GraphCacheSection));
+
+      const char zeros[graphCacheAlignment] = {};
+      std::uint64_t pos = sizeof(header) + table.size() * sizeof(GraphCacheSection);
+      for (auto i = 0u; i < sections.size(); ++i) {
+        out.write(zeros, table[i].offset - pos);
+        out.write(sections[i].data, sections[i].bytes);
+        pos = table[i].offset + sections[i].bytes;
+      }
+
+      if (!out) {
+        std::remove(tmp.c_str());
+        return false;
+      }
+    }
+
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+  }
+};
+
+class GraphCache {
+ private:
+  std::shared_ptr<const MappedFile> file;
+  const GraphCacheSection * table = nullptr;
+  std::uint32_t numSections = 0;
+
+ public:
+  // Map the cache at path, or nullptr if there isn't one or it was written
+  // for a different key
+  static std::shared_ptr<const GraphCache> open(const std::string & path, std::uint64_t key) {
+    std::shared_ptr<const MappedFile> f;
+    try {
+      f = std::make_shared<const MappedFile>(path);
+    } catch (const std::runtime_error &) {
+      return nullptr;
+    }
+
+    GraphCacheHeader header;
+    if (f->size() < sizeof(header)) {
+      return nullptr;
+    }
+    std::memcpy(&header, f->begin(), sizeof(header));
+    if (std::memcmp(header.magic, "YPGRAPH", sizeof(header.magic)) != 0 ||
+        header.version != graphCacheVersion || header.key != key ||
+        f->size() < sizeof(header) + header.numSections * sizeof(GraphCacheSection)) {
+      return nullptr;
+    }
+
+    auto cache = std::make_shared<GraphCache>();
+    cache->file = f;
+    cache->table = reinterpret_cast<const GraphCacheSection *>(f->begin() + sizeof(header));
+    cache->numSections = header.numSections;
+    for (auto i = 0u; i < cache->numSections; ++i) {
+      const auto & s = cache->table[i];
+      if (s.offset % graphCacheAlignment != 0 || s.offset + s.bytes > f->size()) {
+        return nullptr;
+      }
+    }
+    return cache;
+  }
+
+  std::uint32_t sections() const {
+    return numSections;
+  }
+
+  // Section i in place, as a pointer and number of elements. Only valid for
+  // as long as the cache is.
+  template <typename T>
+  std::pair<const T *, std::size_t> section(unsigned i) const {
+    static_assert(std::is_trivially_copyable<T>::value, "Graph cache sections must be trivially copyable");
+    const auto & s = table[i];
+    return {reinterpret_cast<const T *>(file->begin() + s.offset), s.bytes / sizeof(T)};
+  }
+
+  template <typename T>
+  std::vector<T> copySection(unsigned i) const {
+    auto s = section<T>(i);
+    return std::vector<T>(s.first, s.first + s.second);
+  }
+};
+
+}}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef YEWPAR_INCUMBENT_HPP
 #define YEWPAR_INCUMBENT_HPP
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -45,10 +46,19 @@ struct Incumbent : public hpx::components::locking_hook<
     Node incumbentNode;
     Bound bnd;
 
+    // Anytime search
+    std::chrono::steady_clock::time_point startTime;
+    std::function<void(const Node &, Bound, std::chrono::milliseconds)> callback;
+
   public:
     void initialiseIncumbent(Node n, Bound b) {
       incumbentNode = n;
       bnd = b;
+      startTime = std::chrono::steady_clock::now();
+    }
+
+    void setCallback(std::function<void(const Node &, Bound, std::chrono::milliseconds)> cb) {
+      callback = cb;
     }
 
     void updateIncumbent(Node incumbent) {
@@ -59,6 +69,13 @@ struct Incumbent : public hpx::components::locking_hook<
         if constexpr(verbose >= 1) {
           hpx::cout << (boost::format("New Incumbent Bound: %1%\n") % incumbentNode.getObj()) << hpx::flush;
         }
+        // Updates are serialised by the component lock so the callback sees
+        // incumbents in order
+        if (callback) {
+          auto t = std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - startTime);
+          callback(incumbentNode, bnd, t);
+        }
       }
     }
 
@@ -74,6 +91,16 @@ struct Incumbent : public hpx::components::locking_hook<
     cmp->initialiseIncumbent(n, b);
   }
 
+  // Local only (std::function isn't serialisable). The incumbent always lives
+  // on the locality that started the search so the skeleton can set this
+  // through hpx::get_ptr.
+  template<typename Node, typename Bound, typename Cmp, typename Verbose>
+  void setCallback(std::function<void(const Node &, Bound, std::chrono::milliseconds)> cb) {
+    auto p = ptr.get();
+    auto cmp = static_cast<Incumbent::IncumbentComp<Node, Bound, Cmp, Verbose>*>(p);
+    cmp->setCallback(cb);
+  }
+
   template<typename Node, typename Bound, typename Cmp, typename Verbose>
   void updateIncumbent(Node incumbent) {
     auto p = ptr.get();
@@ -0,0 +1,68 @@
+#ifndef YEWPAR_MAPPEDFILE_HPP
+#define YEWPAR_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace YewPar { namespace util {
+
+// Read only view of a whole file through mmap, so parsers can scan the bytes
+// in place instead of copying them line by line through an ifstream. Throws
+// std::runtime_error if the file can't be opened or mapped.
+class MappedFile {
+ private:
+  const char * data_ = nullptr;
+  std::size_t size_ = 0;
+
+ public:
+  explicit MappedFile(const std::string & filename) {
+    auto fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("unable to open file");
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("unable to stat file");
+    }
+    size_ = st.st_size;
+
+    // mmap refuses empty mappings, an empty file is just an empty range
+    if (size_ > 0) {
+      auto p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("unable to map file");
+      }
+      ::madvise(p, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char *>(p);
+    }
+
+    // The mapping outlives the descriptor
+    ::close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  const char * begin() const { return data_; }
+  const char * end() const { return data_ + size_; }
+  std::size_t size() const { return size_; }
+};
+
+}}
+
+#endif
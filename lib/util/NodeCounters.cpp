@@ -0,0 +1,124 @@
+#include "NodeCounters.hpp"
+
+#include <chrono>
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/lcos/broadcast.hpp>
+#include <hpx/performance_counters/manage_counter_type.hpp>
+
+#include <boost/format.hpp>
+
+namespace YewPar { namespace NodeCounters {
+
+util::ShardedCounter processed;
+util::ShardedCounter pruned;
+util::ShardedCounter broken;
+
+namespace {
+std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+// The HPX counters report the counts since they were last reset. Node limits
+// and progress reports read the same counts so the counters keep the total
+// at their last reset rather than zeroing anything.
+std::atomic<std::uint64_t> processedBase {0};
+std::atomic<std::uint64_t> prunedBase {0};
+std::atomic<std::uint64_t> brokenBase {0};
+
+std::uint64_t sinceReset(const util::ShardedCounter & cntr,
+                         std::atomic<std::uint64_t> & base,
+                         bool reset) {
+  auto total = cntr.load();
+  auto res = total - base.load();
+  if (reset) {
+    base = total;
+  }
+  return res;
+}
+
+std::uint64_t getProcessed(bool reset) { return sinceReset(processed, processedBase, reset); }
+std::uint64_t getPruned(bool reset) { return sinceReset(pruned, prunedBase, reset); }
+std::uint64_t getBroken(bool reset) { return sinceReset(broken, brokenBase, reset); }
+}
+
+void reset() {
+  processed.reset();
+  pruned.reset();
+  broken.reset();
+  processedBase = 0;
+  prunedBase = 0;
+  brokenBase = 0;
+  startTime = std::chrono::steady_clock::now();
+}
+
+Totals localTotals() {
+  Totals t;
+  t.processed = processed.load();
+  t.pruned = pruned.load();
+  t.broken = broken.load();
+  return t;
+}
+
+std::vector<Totals> perWorker() {
+  std::vector<Totals> res;
+  auto n = std::min<std::size_t>(hpx::get_os_thread_count(), util::ShardedCounter::maxWorkers);
+  for (auto i = 0; i < n; ++i) {
+    Totals t;
+    t.processed = processed.load(i);
+    t.pruned = pruned.load(i);
+    t.broken = broken.load(i);
+    res.push_back(t);
+  }
+  return res;
+}
+
+void printSummary() {
+  auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  auto pruneRatio = [](const Totals & t) {
+    return t.processed == 0 ? 0.0 : static_cast<double>(t.pruned) / t.processed;
+  };
+
+  auto localities = hpx::find_all_localities();
+  auto workers = hpx::lcos::broadcast<perWorker_act>(localities).get();
+
+  Totals total;
+  for (auto l = 0; l < workers.size(); ++l) {
+    for (auto w = 0; w < workers[l].size(); ++w) {
+      const auto & t = workers[l][w];
+      hpx::cout << (boost::format("Locality %1% Worker %2%: %3% nodes, %4% nodes/s, prune ratio %5$.3f, levels broken %6%\n")
+                    % hpx::naming::get_locality_id_from_id(localities[l]) % w
+                    % t.processed % static_cast<std::uint64_t>(t.processed / secs)
+                    % pruneRatio(t) % t.broken);
+      total += t;
+    }
+  }
+
+  hpx::cout << (boost::format("Total: %1% nodes, %2% nodes/s, prune ratio %3$.3f, levels broken %4%\n")
+                % total.processed % static_cast<std::uint64_t>(total.processed / secs)
+                % pruneRatio(total) % total.broken) << hpx::flush;
+}
+
+void registerPerformanceCounters() {
+  hpx::performance_counters::install_counter_type(
+      "/yewpar/nodes/processed",
+      &getProcessed,
+      "Returns the number of search tree nodes processed on this locality"
+                                                  );
+
+  hpx::performance_counters::install_counter_type(
+      "/yewpar/nodes/pruned",
+      &getPruned,
+      "Returns the number of nodes pruned by the bound function on this locality"
+                                                  );
+
+  hpx::performance_counters::install_counter_type(
+      "/yewpar/nodes/levelsBroken",
+      &getBroken,
+      "Returns the number of times PruneLevel skipped the remaining siblings on this locality"
+                                                  );
+}
+
+}}
+
+HPX_REGISTER_ACTION(YewPar::NodeCounters::localTotals_act, yewpar_node_counters_local_totals_act);
+HPX_REGISTER_ACTION(YewPar::NodeCounters::perWorker_act, yewpar_node_counters_per_worker_act);
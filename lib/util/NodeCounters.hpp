@@ -0,0 +1,80 @@
+#ifndef YEWPAR_NODECOUNTERS_HPP
+#define YEWPAR_NODECOUNTERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <hpx/runtime/actions/plain_action.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+
+#include "ShardedCounter.hpp"
+
+// Search statistics: nodes processed, nodes pruned by the bound and levels
+// cut by PruneLevel, each a ShardedCounter so counting never contends. Totals
+// are only formed when read (by the /yewpar/nodes/... performance counters,
+// the progress reporter or the end of search summary).
+//
+// Built with YEWPAR_NODE_COUNTERS (the default, see the cmake option) every
+// search counts. Without it counting only happens when a search needs the
+// numbers (node limits and progress reporting).
+
+namespace YewPar { namespace NodeCounters {
+
+#ifdef YEWPAR_NODE_COUNTERS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+extern util::ShardedCounter processed;
+extern util::ShardedCounter pruned;
+extern util::ShardedCounter broken;
+
+struct Totals {
+  std::uint64_t processed = 0;
+  std::uint64_t pruned = 0;
+  std::uint64_t broken = 0;
+
+  Totals & operator+=(const Totals & o) {
+    processed += o.processed;
+    pruned += o.pruned;
+    broken += o.broken;
+    return *this;
+  }
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & processed;
+    ar & pruned;
+    ar & broken;
+  }
+};
+
+// Returns this worker's count so far
+inline std::uint64_t countProcessed() { return processed.increment(); }
+inline void countPruned() { pruned.increment(); }
+inline void countBroken() { broken.increment(); }
+
+// Zero every counter on this locality. Called when a parallel search starts.
+void reset();
+
+Totals localTotals();
+HPX_DEFINE_PLAIN_ACTION(localTotals, localTotals_act);
+
+// One entry per worker thread on this locality
+std::vector<Totals> perWorker();
+HPX_DEFINE_PLAIN_ACTION(perWorker, perWorker_act);
+
+// Print per worker and overall throughput and prune ratios for every
+// locality, measured from the last reset()
+void printSummary();
+
+void registerPerformanceCounters();
+
+}}
+
+HPX_REGISTER_ACTION_DECLARATION(YewPar::NodeCounters::localTotals_act, yewpar_node_counters_local_totals_act);
+HPX_REGISTER_ACTION_DECLARATION(YewPar::NodeCounters::perWorker_act, yewpar_node_counters_per_worker_act);
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef UTIL_LAZY_NODEGENERATOR_HPP
 #define UTIL_LAZY_NODEGENERATOR_HPP
 
+#include <optional>
+#include <type_traits>
+
 namespace YewPar {
 
 #include <hpx/util/tuple.hpp>
@@ -27,6 +30,39 @@ struct NodeGenerator {
   };
 };
 
+// Generators that can use the incumbent, e.g. to skip children that are sure
+// to be pruned, may also provide
+//   Generator(const Space &, const Node &, IncumbentBound<Bound>)
+// Optimisation and Decision searches use it when it exists, giving the best
+// bound the worker knows of when the node is expanded (params.initialBound
+// for Decision searches). The Restarts skeleton is the exception as it uses
+// its own seeded constructor. Generator(const Space &, const Node &) must
+// always give the same children in the same order: skeletons that name
+// children by their index (e.g. DepthBounded checkpoints) only use that.
+template <typename Bound>
+struct IncumbentBound {
+  Bound bound;
+};
+
+template <typename Generator, typename Bound>
+constexpr bool takesIncumbentBound = std::is_constructible<Generator,
+                                                           const typename Generator::Spacetype &,
+                                                           const typename Generator::Nodetype &,
+                                                           IncumbentBound<Bound> >::value;
+
+// Generator for n, given bnd if there is one and the generator takes it
+template <typename Generator, typename Bound>
+Generator makeGenerator(const typename Generator::Spacetype & space,
+                        const typename Generator::Nodetype & n,
+                        const std::optional<Bound> & bnd) {
+  if constexpr(takesIncumbentBound<Generator, Bound>) {
+    if (bnd) {
+      return Generator(space, n, IncumbentBound<Bound>{*bnd});
+    }
+  }
+  return Generator(space, n);
+}
+
 }
 
 #endif
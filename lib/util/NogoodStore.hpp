@@ -0,0 +1,103 @@
+#ifndef YEWPAR_NOGOODSTORE_HPP
+#define YEWPAR_NOGOODSTORE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <hpx/lcos/local/mutex.hpp>
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/traits/action_stacksize.hpp>
+
+namespace YewPar {
+
+// Per-locality store of the nogoods learned by the Restarts skeleton. A nogood
+// is a list of decisions (see Node::Decision) that can't all hold in any
+// solution. The store keeps at most limit nogoods, dropping the oldest first.
+// Nogoods are numbered in the order they are added, so when workers restart
+// they only fetch the ones they haven't seen and searching never locks.
+template <typename Space, typename Node>
+struct NogoodStore {
+  static NogoodStore<Space, Node>* gReg;
+
+  using Nogood = std::vector<typename Node::Decision>;
+
+  using mutex_t = hpx::lcos::local::mutex;
+  mutex_t mtx;
+
+  std::deque<Nogood> nogoods;
+  std::uint64_t limit = 0;
+  // Number of the oldest nogood kept
+  std::uint64_t first = 0;
+
+  void initialise(std::uint64_t limit) {
+    std::lock_guard<mutex_t> l(mtx);
+    nogoods.clear();
+    this->limit = limit;
+    first = 0;
+  }
+
+  void add(const std::vector<Nogood> & ns) {
+    if (ns.empty()) {
+      return;
+    }
+
+    std::lock_guard<mutex_t> l(mtx);
+    nogoods.insert(nogoods.end(), ns.begin(), ns.end());
+    while (nogoods.size() > limit) {
+      nogoods.pop_front();
+      ++first;
+    }
+  }
+
+  // Append the nogoods numbered from on that are still kept to out, returning
+  // the number of the next nogood to be added
+  std::uint64_t fetch(std::vector<Nogood> & out, std::uint64_t from) {
+    std::lock_guard<mutex_t> l(mtx);
+    auto next = first + nogoods.size();
+    for (auto i = std::max(from, first); i < next; ++i) {
+      out.push_back(nogoods[i - first]);
+    }
+    return next;
+  }
+};
+
+template <typename Space, typename Node>
+NogoodStore<Space, Node>* NogoodStore<Space, Node>::gReg = new NogoodStore<Space, Node>;
+
+template <typename Space, typename Node>
+void initialiseNogoodStore(std::uint64_t limit) {
+  NogoodStore<Space, Node>::gReg->initialise(limit);
+}
+template <typename Space, typename Node>
+struct InitNogoodStoreAct : hpx::actions::make_direct_action<
+  decltype(&initialiseNogoodStore<Space, Node>), &initialiseNogoodStore<Space, Node>, InitNogoodStoreAct<Space, Node> >::type {};
+
+template <typename Space, typename Node>
+void addNogoods(std::vector<typename NogoodStore<Space, Node>::Nogood> nogoods) {
+  NogoodStore<Space, Node>::gReg->add(nogoods);
+}
+template <typename Space, typename Node>
+struct AddNogoodsAct : hpx::actions::make_action<
+  decltype(&addNogoods<Space, Node>), &addNogoods<Space, Node>, AddNogoodsAct<Space, Node> >::type {};
+
+} // YewPar
+
+namespace hpx { namespace traits {
+
+template <typename Space, typename Node>
+struct action_stacksize<YewPar::InitNogoodStoreAct<Space, Node> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+template <typename Space, typename Node>
+struct action_stacksize<YewPar::AddNogoodsAct<Space, Node> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+}}
+
+#endif
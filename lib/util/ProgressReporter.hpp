@@ -0,0 +1,215 @@
+#ifndef YEWPAR_PROGRESSREPORTER_HPP
+#define YEWPAR_PROGRESSREPORTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <hpx/include/async.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/broadcast.hpp>
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/get_locality_id.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/traits/action_stacksize.hpp>
+
+#include "skeletons/API.hpp"
+#include "util/NodeCounters.hpp"
+#include "util/Registry.hpp"
+#include "workstealing/policies/Policy.hpp"
+
+namespace Workstealing { namespace Scheduler {
+extern std::shared_ptr<Policy> local_policy;
+std::vector<std::uint64_t> getIdleTimes();
+}}
+
+namespace YewPar {
+
+// Statistics for a single locality
+struct LocalityProgress {
+  std::uint32_t locality;
+  std::uint64_t nodes;
+  std::uint64_t prunes;
+  std::vector<std::uint64_t> poolSizes;
+  StealStats steals;
+  std::vector<std::uint64_t> idleTimes;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & locality;
+    ar & nodes;
+    ar & prunes;
+    ar & poolSizes;
+    ar & steals;
+    ar & idleTimes;
+  }
+};
+
+template <typename Space, typename Node, typename Bound>
+LocalityProgress getLocalityProgress() {
+  auto totals = NodeCounters::localTotals();
+
+  LocalityProgress p;
+  p.locality = hpx::get_locality_id();
+  p.nodes = totals.processed;
+  p.prunes = totals.pruned;
+  if (auto policy = Workstealing::Scheduler::local_policy) {
+    p.poolSizes = policy->poolSizes();
+    p.steals = policy->stealStats();
+  }
+  p.idleTimes = Workstealing::Scheduler::getIdleTimes();
+  return p;
+}
+// Not a direct action: poolSizes() waits on the pool component, which can be
+// locked by a busy worker, so this must not run on the parcel thread.
+template <typename Space, typename Node, typename Bound>
+struct GetLocalityProgressAct : hpx::actions::make_action<
+  decltype(&getLocalityProgress<Space, Node, Bound>), &getLocalityProgress<Space, Node, Bound>, GetLocalityProgressAct<Space, Node, Bound> >::type {};
+
+// Periodically gathers statistics from every locality and writes them as a
+// single JSON object per line, e.g. for spotting stalled or badly balanced
+// runs while they are still going.
+template <typename Space, typename Node, typename Bound>
+class ProgressReporter {
+ private:
+  std::shared_ptr<std::atomic<bool> > done;
+  hpx::future<void> reporter;
+
+  template <typename T>
+  static void writeArray(std::ostream & os, const std::vector<T> & xs) {
+    os << "[";
+    for (auto i = 0; i < xs.size(); ++i) {
+      os << (i == 0 ? "" : ",") << xs[i];
+    }
+    os << "]";
+  }
+
+  static std::string report(std::uint64_t elapsedMs,
+                            double nodesPerSec,
+                            bool reportIncumbent,
+                            const std::vector<LocalityProgress> & locs) {
+    std::uint64_t nodes = 0, prunes = 0;
+    for (const auto & l : locs) {
+      nodes += l.nodes;
+      prunes += l.prunes;
+    }
+
+    std::ostringstream os;
+    os << "{\"elapsed_ms\":" << elapsedMs
+       << ",\"nodes\":" << nodes
+       << ",\"nodes_per_sec\":" << static_cast<std::uint64_t>(nodesPerSec)
+       << ",\"prunes\":" << prunes;
+
+    if constexpr(std::is_arithmetic<Bound>::value) {
+      if (reportIncumbent) {
+        os << ",\"incumbent\":" << Registry<Space, Node, Bound>::gReg->localBound.load();
+      }
+    }
+
+    os << ",\"localities\":[";
+    for (auto i = 0; i < locs.size(); ++i) {
+      const auto & l = locs[i];
+      auto attempts = l.steals.localSteals + l.steals.failedLocalSteals +
+                      l.steals.distributedSteals + l.steals.failedDistributedSteals;
+      auto successes = l.steals.localSteals + l.steals.distributedSteals;
+
+      std::vector<std::uint64_t> idleMs;
+      for (auto t : l.idleTimes) {
+        idleMs.push_back(t / 1000);
+      }
+
+      os << (i == 0 ? "" : ",")
+         << "{\"locality\":" << l.locality
+         << ",\"nodes\":" << l.nodes
+         << ",\"prunes\":" << l.prunes
+         << ",\"pool_sizes\":";
+      writeArray(os, l.poolSizes);
+      os << ",\"steals\":{\"local\":" << l.steals.localSteals
+         << ",\"local_failed\":" << l.steals.failedLocalSteals
+         << ",\"distributed\":" << l.steals.distributedSteals
+         << ",\"distributed_failed\":" << l.steals.failedDistributedSteals
+         << ",\"success_rate\":" << (attempts == 0 ? 0.0 : static_cast<double>(successes) / attempts)
+         << "},\"idle_ms\":";
+      writeArray(os, idleMs);
+      os << "}";
+    }
+    os << "]}";
+    return os.str();
+  }
+
+ public:
+  void start(const Skeletons::API::Params<Bound> & params, const bool reportIncumbent) {
+    done = std::make_shared<std::atomic<bool> >(false);
+
+    std::shared_ptr<std::ofstream> file;
+    if (!params.progressFile.empty()) {
+      file = std::make_shared<std::ofstream>(params.progressFile, std::ios::trunc);
+    }
+
+    auto finished = done;
+    auto interval = std::chrono::seconds(params.progressInterval);
+    hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_high);
+    reporter = hpx::async(exe, [=]() {
+        auto startTime = std::chrono::steady_clock::now();
+        auto last = startTime;
+        std::uint64_t lastNodes = 0;
+
+        while (!*finished) {
+          // Poll rather than sleeping the full interval so stop() returns quickly
+          hpx::this_thread::sleep_for(std::chrono::milliseconds(100));
+          auto now = std::chrono::steady_clock::now();
+          if (now - last < interval) {
+            continue;
+          }
+
+          auto locs = hpx::lcos::broadcast<GetLocalityProgressAct<Space, Node, Bound> >(
+              hpx::find_all_localities()).get();
+          auto nodes = std::accumulate(locs.begin(), locs.end(), std::uint64_t(0),
+                                       [](std::uint64_t n, const LocalityProgress & l) { return n + l.nodes; });
+
+          auto secs = std::chrono::duration<double>(now - last).count();
+          auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime);
+          auto line = report(elapsed.count(), (nodes - lastNodes) / secs, reportIncumbent, locs);
+
+          if (file) {
+            *file << line << std::endl;
+          } else {
+            hpx::cout << line << "\n" << hpx::flush;
+          }
+
+          last = now;
+          lastNodes = nodes;
+        }
+      });
+  }
+
+  // Must be called once the search has finished
+  void stop() {
+    if (done) {
+      *done = true;
+      reporter.get();
+      done.reset();
+    }
+  }
+};
+
+} // YewPar
+
+namespace hpx { namespace traits {
+
+template <typename Space, typename Node, typename Bound>
+struct action_stacksize<YewPar::GetLocalityProgressAct<Space, Node, Bound> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+}}
+
+#endif
@@ -9,9 +9,13 @@
 #include <vector>
 
 #include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/get_os_thread_count.hpp>
+#include <hpx/runtime/get_worker_thread_num.hpp>
+#include <hpx/runtime/serialization/string.hpp>
 #include <hpx/traits/action_stacksize.hpp>
 
 #include "skeletons/API.hpp"
+#include "util/NodeCounters.hpp"
 
 namespace YewPar {
 
@@ -25,13 +29,28 @@ struct Registry {
 
   Skeletons::API::Params<Bound> params;
 
+  // The bound and stop flag are read by every worker on (almost) every node
+  // but rarely written, so each gets a cache line to itself. The alignment on
+  // the following member stops them sharing a line with anything else.
+
   // BNB
-  std::atomic<Bound> localBound;
-  hpx::naming::id_type globalIncumbent;
+  alignas(64) std::atomic<Bound> localBound;
+  alignas(64) hpx::naming::id_type globalIncumbent;
 
   // Decision problems
-  std::atomic<bool> stopSearch {false};
-  hpx::naming::id_type foundPromiseId;
+  alignas(64) std::atomic<bool> stopSearch {false};
+  alignas(64) hpx::naming::id_type foundPromiseId;
+
+  // Each worker prunes against its own copy of localBound, refreshed every
+  // boundRefreshInterval nodes (and after the worker itself updates the
+  // bound), so the hot path doesn't touch the shared line. A stale bound is
+  // always weaker than the real one so at worst we prune a little less.
+  static constexpr unsigned boundRefreshInterval = 64;
+  struct alignas(64) BoundCache {
+    Bound bound;
+    unsigned untilRefresh = 0;
+  };
+  std::vector<BoundCache> boundCaches;
 
   // Counting Nodes
   using countMapT = std::vector<std::atomic<std::uint64_t> >;
@@ -45,6 +64,9 @@ struct Registry {
     this->root = root;
     this->params = params;
     this->localBound = params.initialBound;
+    this->stopSearch = false;
+    boundCaches = std::vector<BoundCache>(hpx::get_os_thread_count());
+    NodeCounters::reset();
     counts = std::make_unique<std::vector<std::atomic<std::uint64_t> > >(params.maxDepth + 1);
   }
 
@@ -77,12 +99,46 @@ struct Registry {
         break;
       }
     }
+    invalidateBoundCache();
+  }
+
+  Bound cachedBound() {
+    auto worker = hpx::get_worker_thread_num();
+    if (worker >= boundCaches.size()) {
+      return localBound.load(std::memory_order_relaxed);
+    }
+
+    // No locking: an HPX thread can't be suspended in here so nothing else
+    // touches this worker's cache while we do
+    auto & c = boundCaches[worker];
+    if (c.untilRefresh == 0) {
+      c.bound = localBound.load(std::memory_order_relaxed);
+      c.untilRefresh = boundRefreshInterval;
+    }
+    --c.untilRefresh;
+    return c.bound;
+  }
+
+  void invalidateBoundCache() {
+    auto worker = hpx::get_worker_thread_num();
+    if (worker < boundCaches.size()) {
+      boundCaches[worker].untilRefresh = 0;
+    }
+  }
+
+  // Nothing is published through the stop flag so relaxed loads are enough
+  bool stopped() const {
+    return stopSearch.load(std::memory_order_relaxed);
   }
 
   void setStopSearchFlag() {
     stopSearch.store(true);
   }
 
+  std::uint64_t getNodesProcessed() {
+    return NodeCounters::localTotals().processed;
+  }
+
 };
 
 template<typename Space, typename Node, typename Bound>
@@ -113,6 +169,14 @@ template <typename Space, typename Node, typename Bound>
 struct SetStopFlagAct : hpx::actions::make_direct_action<
   decltype(&setStopSearchFlag<Space, Node, Bound>), &setStopSearchFlag<Space, Node, Bound>, SetStopFlagAct<Space, Node, Bound> >::type {};
 
+template <typename Space, typename Node, typename Bound>
+std::uint64_t getNodesProcessed() {
+  return Registry<Space, Node, Bound>::gReg->getNodesProcessed();
+}
+template <typename Space, typename Node, typename Bound>
+struct GetNodesProcessedAct : hpx::actions::make_direct_action<
+  decltype(&getNodesProcessed<Space, Node, Bound>), &getNodesProcessed<Space, Node, Bound>, GetNodesProcessedAct<Space, Node, Bound> >::type {};
+
 template <typename Space, typename Node, typename Bound, typename Cmp>
 void updateRegistryBound(Bound bnd) {
   auto reg = Registry<Space, Node, Bound>::gReg;
@@ -171,6 +235,11 @@ struct action_stacksize<YewPar::GetCountsAct<Space, Node, Bound> > {
   enum { value = threads::thread_stacksize_huge };
 };
 
+template <typename Space, typename Node, typename Bound>
+struct action_stacksize<YewPar::GetNodesProcessedAct<Space, Node, Bound> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
 }}
 
 #endif
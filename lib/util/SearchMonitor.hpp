@@ -0,0 +1,111 @@
+#ifndef YEWPAR_SEARCHMONITOR_HPP
+#define YEWPAR_SEARCHMONITOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+
+#include <hpx/include/async.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/broadcast.hpp>
+
+#include <boost/format.hpp>
+
+#include "skeletons/API.hpp"
+#include "util/ProgressReporter.hpp"
+#include "util/Registry.hpp"
+
+namespace YewPar {
+
+// Anytime search support. Runs as a light-weight thread on the master locality
+// for the duration of a search and sets the stop flag on every locality once a
+// time/node/optimality gap limit from the Params is reached. Skeletons then
+// unwind and return whatever incumbent (or counts) they have so far.
+// Also owns the optional ProgressReporter since it has the same lifetime.
+template <typename Space, typename Node, typename Bound>
+class SearchMonitor {
+ private:
+  std::shared_ptr<std::atomic<bool> > done;
+  hpx::future<void> monitor;
+  ProgressReporter<Space, Node, Bound> reporter;
+
+  static constexpr std::chrono::milliseconds pollInterval {10};
+
+ public:
+  // gapClosed is empty if there is no gap to check
+  void start(const Skeletons::API::Params<Bound> & params,
+             std::function<bool()> gapClosed,
+             const unsigned verbose,
+             const bool reportIncumbent) {
+    if (params.progressInterval > 0) {
+      reporter.start(params, reportIncumbent);
+    }
+
+    if (params.timeLimit == 0 && params.nodeLimit == 0 && !gapClosed) {
+      return;
+    }
+
+    done = std::make_shared<std::atomic<bool> >(false);
+
+    auto finished = done;
+    auto startTime = std::chrono::steady_clock::now();
+    hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_high);
+    monitor = hpx::async(exe, [=]() {
+        while (!*finished) {
+          std::string reason;
+
+          auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - startTime);
+          if (params.timeLimit > 0 && static_cast<std::uint64_t>(elapsed.count()) >= params.timeLimit) {
+            reason = "time limit";
+          }
+
+          if (reason.empty() && params.nodeLimit > 0) {
+            auto nodes = hpx::lcos::broadcast<GetNodesProcessedAct<Space, Node, Bound> >(
+                hpx::find_all_localities()).get();
+            if (std::accumulate(nodes.begin(), nodes.end(), std::uint64_t(0)) >= params.nodeLimit) {
+              reason = "node limit";
+            }
+          }
+
+          if (reason.empty() && gapClosed && gapClosed()) {
+            reason = "optimality gap";
+          }
+
+          if (!reason.empty()) {
+            if (verbose >= 1) {
+              hpx::cout << (boost::format("Stopping search: %1% reached after %2% ms\n")
+                            % reason % elapsed.count()) << hpx::flush;
+            }
+            hpx::wait_all(hpx::lcos::broadcast<SetStopFlagAct<Space, Node, Bound> >(
+                hpx::find_all_localities()));
+            return;
+          }
+
+          hpx::this_thread::sleep_for(pollInterval);
+        }
+      });
+  }
+
+  // Must be called once the search has finished
+  void stop() {
+    reporter.stop();
+    if (done) {
+      *done = true;
+      monitor.get();
+      done.reset();
+    }
+  }
+};
+
+template <typename Space, typename Node, typename Bound>
+constexpr std::chrono::milliseconds SearchMonitor<Space, Node, Bound>::pollInterval;
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef YEWPAR_SHARDEDCOUNTER_HPP
+#define YEWPAR_SHARDEDCOUNTER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include <hpx/runtime/get_worker_thread_num.hpp>
+
+namespace YewPar { namespace util {
+
+// A counter split into one cache line per worker thread so that increments
+// from different workers never contend. Only the owning worker writes to its
+// slot so an increment is a plain load/store. Reads sum every slot, which is
+// fine for counters that are incremented often but read rarely (e.g.
+// performance counters).
+class ShardedCounter {
+ public:
+  // Workers beyond this (and non-worker threads) share the final slot
+  static constexpr std::size_t maxWorkers = 256;
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> count {0};
+  };
+  Slot slots[maxWorkers + 1];
+
+ public:
+  // Returns the count in this worker's slot
+  std::uint64_t increment() {
+    auto worker = hpx::get_worker_thread_num();
+    if (worker < maxWorkers) {
+      auto & c = slots[worker].count;
+      auto n = c.load(std::memory_order_relaxed) + 1;
+      c.store(n, std::memory_order_relaxed);
+      return n;
+    }
+    return slots[maxWorkers].count.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  ShardedCounter & operator++() {
+    increment();
+    return *this;
+  }
+
+  void operator++(int) {
+    increment();
+  }
+
+  std::uint64_t load() const {
+    std::uint64_t res = 0;
+    for (const auto & s : slots) {
+      res += s.count.load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+  // The count of a single worker
+  std::uint64_t load(std::size_t worker) const {
+    return slots[worker < maxWorkers ? worker : maxWorkers].count.load(std::memory_order_relaxed);
+  }
+
+  // Increments racing with a reset may be lost
+  void reset() {
+    for (auto & s : slots) {
+      s.count.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+}}
+
+#endif
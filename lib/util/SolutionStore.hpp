@@ -0,0 +1,189 @@
+#ifndef YEWPAR_SOLUTIONSTORE_HPP
+#define YEWPAR_SOLUTIONSTORE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <hpx/lcos/local/mutex.hpp>
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/get_locality_id.hpp>
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/traits/action_stacksize.hpp>
+
+#include "skeletons/API.hpp"
+
+namespace YewPar {
+
+// Per-locality sink for the AllSolutions and TopK search types. Workers only
+// ever talk to the store on their own locality, results are gathered once at
+// the end of the search.
+//
+// AllSolutions: solutions are buffered in memory. If a solutionFile is given
+// the buffer is spilled to "<solutionFile>.<locality>" once it holds
+// solutionBufferSize nodes, and on completion, keeping memory bounded.
+//
+// TopK: keeps the k best nodes seen on this locality as a heap with the worst
+// at the front. Once full the worst value is a valid pruning bound for every
+// locality, since the global k-th best can only be better.
+template <typename Space, typename Node, typename Bound, typename Cmp>
+struct SolutionStore {
+  static SolutionStore<Space, Node, Bound, Cmp>* gReg;
+
+  using mutex_t = hpx::lcos::local::mutex;
+  mutex_t mtx;
+  mutex_t fileMtx;
+
+  Skeletons::API::Params<Bound> params;
+  std::vector<Node> solutions;
+  std::uint64_t spilled = 0;
+
+  void initialise(Skeletons::API::Params<Bound> params) {
+    this->params = params;
+    solutions.clear();
+    spilled = 0;
+
+    if (!params.solutionFile.empty()) {
+      // Truncate anything from a previous run
+      std::ofstream(spillFileName(), std::ios::binary | std::ios::trunc);
+    }
+  }
+
+  std::string spillFileName() const {
+    return params.solutionFile + "." + std::to_string(hpx::get_locality_id());
+  }
+
+  // Solutions are written as length prefixed chunks of serialised nodes, see
+  // readSpilledSolutions
+  void spill(const std::vector<Node> & toWrite) {
+    std::vector<char> data;
+    {
+      hpx::serialization::output_archive oa(data);
+      oa << toWrite;
+    }
+
+    std::lock_guard<mutex_t> l(fileMtx);
+    std::ofstream f(spillFileName(), std::ios::binary | std::ios::app);
+    std::uint64_t sz = data.size();
+    f.write(reinterpret_cast<const char *>(&sz), sizeof(sz));
+    f.write(data.data(), data.size());
+  }
+
+  // AllSolutions
+  void addSolution(const Node & n) {
+    std::vector<Node> toWrite;
+    {
+      std::lock_guard<mutex_t> l(mtx);
+      solutions.push_back(n);
+      if (!params.solutionFile.empty() && solutions.size() >= params.solutionBufferSize) {
+        spilled += solutions.size();
+        std::swap(toWrite, solutions);
+      }
+    }
+
+    // Don't hold up other workers while we write
+    if (!toWrite.empty()) {
+      spill(toWrite);
+    }
+  }
+
+  // TopK. Returns true, and sets kth, if the k-th best value on this locality
+  // changed
+  bool offer(const Node & n, Bound & kth) {
+    auto heapCmp = [](const Node & a, const Node & b) {
+      Cmp cmp;
+      return cmp(a.getObj(), b.getObj());
+    };
+
+    std::lock_guard<mutex_t> l(mtx);
+    if (solutions.size() < params.topK) {
+      solutions.push_back(n);
+      std::push_heap(solutions.begin(), solutions.end(), heapCmp);
+    } else {
+      Cmp cmp;
+      if (!cmp(n.getObj(), solutions.front().getObj())) {
+        return false;
+      }
+      std::pop_heap(solutions.begin(), solutions.end(), heapCmp);
+      solutions.back() = n;
+      std::push_heap(solutions.begin(), solutions.end(), heapCmp);
+    }
+
+    if (solutions.size() == params.topK) {
+      kth = solutions.front().getObj();
+      return true;
+    }
+    return false;
+  }
+
+  // Called once the search has finished. Spilled searches flush everything to
+  // disk and return nothing.
+  std::vector<Node> getSolutions() {
+    std::lock_guard<mutex_t> l(mtx);
+    if (!params.solutionFile.empty() && !solutions.empty()) {
+      spilled += solutions.size();
+      spill(solutions);
+      solutions.clear();
+    }
+    return solutions;
+  }
+};
+
+template <typename Space, typename Node, typename Bound, typename Cmp>
+SolutionStore<Space, Node, Bound, Cmp>* SolutionStore<Space, Node, Bound, Cmp>::gReg = new SolutionStore<Space, Node, Bound, Cmp>;
+
+// Read back the solutions spilled by one locality
+template <typename Node>
+std::vector<Node> readSpilledSolutions(const std::string & fileName) {
+  std::vector<Node> res;
+  std::ifstream f(fileName, std::ios::binary);
+  std::uint64_t sz;
+  while (f.read(reinterpret_cast<char *>(&sz), sizeof(sz))) {
+    std::vector<char> data(sz);
+    f.read(data.data(), sz);
+
+    std::vector<Node> chunk;
+    hpx::serialization::input_archive ia(data, sz);
+    ia >> chunk;
+    res.insert(res.end(), chunk.begin(), chunk.end());
+  }
+  return res;
+}
+
+template <typename Space, typename Node, typename Bound, typename Cmp>
+void initialiseSolutionStore(Skeletons::API::Params<Bound> params) {
+  SolutionStore<Space, Node, Bound, Cmp>::gReg->initialise(params);
+}
+template <typename Space, typename Node, typename Bound, typename Cmp>
+struct InitSolutionStoreAct : hpx::actions::make_direct_action<
+  decltype(&initialiseSolutionStore<Space, Node, Bound, Cmp>), &initialiseSolutionStore<Space, Node, Bound, Cmp>, InitSolutionStoreAct<Space, Node, Bound, Cmp> >::type {};
+
+template <typename Space, typename Node, typename Bound, typename Cmp>
+std::vector<Node> getSolutions() {
+  return SolutionStore<Space, Node, Bound, Cmp>::gReg->getSolutions();
+}
+template <typename Space, typename Node, typename Bound, typename Cmp>
+struct GetSolutionsAct : hpx::actions::make_direct_action<
+  decltype(&getSolutions<Space, Node, Bound, Cmp>), &getSolutions<Space, Node, Bound, Cmp>, GetSolutionsAct<Space, Node, Bound, Cmp> >::type {};
+
+} // YewPar
+
+namespace hpx { namespace traits {
+
+template <typename Space, typename Node, typename Bound, typename Cmp>
+struct action_stacksize<YewPar::InitSolutionStoreAct<Space, Node, Bound, Cmp> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+template <typename Space, typename Node, typename Bound, typename Cmp>
+struct action_stacksize<YewPar::GetSolutionsAct<Space, Node, Bound, Cmp> > {
+  enum { value = threads::thread_stacksize_huge };
+};
+
+}}
+
+#endif
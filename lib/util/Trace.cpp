@@ -0,0 +1,170 @@
+#include "Trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/lcos/broadcast.hpp>
+
+namespace YewPar { namespace Trace {
+
+namespace {
+
+constexpr std::uint64_t bufferSize = YEWPAR_TRACE_BUFFER_SIZE;
+static_assert((bufferSize & (bufferSize - 1)) == 0, "YEWPAR_TRACE_BUFFER_SIZE must be a power of 2");
+
+struct alignas(64) Buffer {
+  std::unique_ptr<Record[]> records;
+  // Total number of events ever written, the buffer holds the last bufferSize
+  std::atomic<std::uint64_t> next {0};
+};
+
+std::unique_ptr<Buffer[]> buffers;
+std::size_t numBuffers = 0;
+std::chrono::steady_clock::time_point epoch;
+
+const char * eventName(Event e) {
+  switch (e) {
+    case Event::TaskStart:    return "task";
+    case Event::TaskEnd:      return "task";
+    case Event::Spawn:        return "spawn";
+    case Event::StealSuccess: return "steal";
+    case Event::StealFailed:  return "steal failed";
+    case Event::Incumbent:    return "incumbent";
+    case Event::IdleStart:    return "idle";
+    case Event::IdleEnd:      return "idle";
+  }
+  return "unknown";
+}
+
+void writeEvent(std::ostream & os, const WorkerTrace & t, const Record & r) {
+  const char * phase;
+  switch (r.event) {
+    case Event::TaskStart:
+    case Event::IdleStart:
+      phase = "B";
+      break;
+    case Event::TaskEnd:
+    case Event::IdleEnd:
+      phase = "E";
+      break;
+    default:
+      phase = "i";
+  }
+
+  // Chrome expects microseconds
+  os << "{\"name\":\"" << eventName(r.event) << "\",\"ph\":\"" << phase << "\""
+     << ",\"ts\":" << r.time / 1000 << "." << (r.time % 1000) / 100
+     << ",\"pid\":" << t.locality << ",\"tid\":" << t.worker;
+
+  switch (r.event) {
+    case Event::StealSuccess:
+    case Event::StealFailed:
+      os << ",\"s\":\"t\",\"args\":{\"victim\":" << r.arg << "}";
+      break;
+    case Event::Incumbent:
+      os << ",\"s\":\"p\",\"args\":{\"bound\":" << r.arg << "}";
+      break;
+    case Event::Spawn:
+      os << ",\"s\":\"t\"";
+      break;
+    default:
+      break;
+  }
+  os << "}";
+}
+
+}
+
+#ifdef YEWPAR_TRACING
+void record(Event e, std::int64_t arg) {
+  auto worker = hpx::get_worker_thread_num();
+  if (worker >= numBuffers) {
+    return;
+  }
+
+  auto & buf = buffers[worker];
+  auto i = buf.next.load(std::memory_order_relaxed);
+  auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - epoch).count();
+  buf.records[i & (bufferSize - 1)] = {static_cast<std::uint64_t>(time), arg, e};
+  buf.next.store(i + 1, std::memory_order_release);
+}
+#endif
+
+void reset() {
+  if constexpr(enabled) {
+    auto n = hpx::get_os_thread_count();
+    if (numBuffers != n) {
+      buffers = std::make_unique<Buffer[]>(n);
+      for (auto i = 0; i < n; ++i) {
+        buffers[i].records = std::make_unique<Record[]>(bufferSize);
+      }
+      numBuffers = n;
+    }
+    for (auto i = 0; i < numBuffers; ++i) {
+      buffers[i].next = 0;
+    }
+    epoch = std::chrono::steady_clock::now();
+  }
+}
+
+std::vector<WorkerTrace> getLocalTrace() {
+  std::vector<WorkerTrace> res;
+  for (auto i = 0; i < numBuffers; ++i) {
+    WorkerTrace t;
+    t.locality = hpx::get_locality_id();
+    t.worker = i;
+
+    auto total = buffers[i].next.load(std::memory_order_acquire);
+    auto first = total > bufferSize ? total - bufferSize : 0;
+    for (auto j = first; j < total; ++j) {
+      t.records.push_back(buffers[i].records[j & (bufferSize - 1)]);
+    }
+    res.push_back(std::move(t));
+  }
+  return res;
+}
+
+void writeChromeTrace(const std::string & fileName) {
+  if constexpr(!enabled) {
+    hpx::cout << "Warning: YewPar was built without YEWPAR_TRACING, no trace written\n" << hpx::flush;
+    return;
+  }
+
+  auto traces = hpx::lcos::broadcast<getLocalTrace_act>(hpx::find_all_localities()).get();
+
+  std::ofstream f(fileName, std::ios::trunc);
+  f << "{\"traceEvents\":[\n";
+  bool first = true;
+  auto sep = [&]() {
+    if (!first) { f << ",\n"; }
+    first = false;
+  };
+
+  for (const auto & loc : traces) {
+    for (const auto & t : loc) {
+      if (t.worker == 0) {
+        sep();
+        f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << t.locality
+          << ",\"args\":{\"name\":\"Locality " << t.locality << "\"}}";
+      }
+      sep();
+      f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << t.locality
+        << ",\"tid\":" << t.worker << ",\"args\":{\"name\":\"Worker " << t.worker << "\"}}";
+
+      for (const auto & r : t.records) {
+        sep();
+        writeEvent(f, t, r);
+      }
+    }
+  }
+  f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+}}
+
+HPX_REGISTER_ACTION(YewPar::Trace::getLocalTrace_act, yewpar_trace_get_local_trace_act);
@@ -0,0 +1,102 @@
+#ifndef YEWPAR_TRACE_HPP
+#define YEWPAR_TRACE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <hpx/runtime/actions/plain_action.hpp>
+#include <hpx/runtime/naming/id_type.hpp>
+#include <hpx/runtime/naming/name.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+
+// Event tracing for scheduler/search diagnostics. Built with -DYEWPAR_TRACING
+// (the YEWPAR_TRACING cmake option) each worker thread records events into its
+// own fixed size ring buffer, keeping the most recent
+// YEWPAR_TRACE_BUFFER_SIZE events. Without it record() is an empty inline
+// function and tracing costs nothing.
+//
+// writeChromeTrace gathers the buffers from every locality and writes them in
+// the Chrome trace event format, viewable in chrome://tracing or Perfetto, with
+// one process per locality and one thread per worker. Timestamps are relative
+// to when the schedulers on each locality were started so are only roughly
+// aligned across localities.
+
+#ifndef YEWPAR_TRACE_BUFFER_SIZE
+#define YEWPAR_TRACE_BUFFER_SIZE 262144
+#endif
+
+namespace YewPar { namespace Trace {
+
+enum class Event : std::uint8_t {
+  TaskStart,
+  TaskEnd,
+  Spawn,
+  // arg is the victim locality, or -1 for a steal from this locality
+  StealSuccess,
+  StealFailed,
+  // arg is the new bound (if it is arithmetic)
+  Incumbent,
+  IdleStart,
+  IdleEnd
+};
+
+struct Record {
+  // Nanoseconds since the trace was started
+  std::uint64_t time;
+  std::int64_t arg;
+  Event event;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & time;
+    ar & arg;
+    ar & event;
+  }
+};
+
+// All events recorded by one worker, oldest first
+struct WorkerTrace {
+  std::uint32_t locality;
+  std::uint32_t worker;
+  std::vector<Record> records;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & locality;
+    ar & worker;
+    ar & records;
+  }
+};
+
+#ifdef YEWPAR_TRACING
+constexpr bool enabled = true;
+
+// Only called by the owning worker so needs no synchronisation. Events from
+// non-worker threads are dropped.
+void record(Event e, std::int64_t arg = 0);
+#else
+constexpr bool enabled = false;
+
+inline void record(Event e, std::int64_t arg = 0) {}
+#endif
+
+inline std::int64_t victimLocality(const hpx::naming::id_type & id) {
+  return hpx::naming::get_locality_id_from_id(id);
+}
+
+// Clear all buffers on this locality and restart the clock. Called whenever
+// the schedulers are started.
+void reset();
+
+std::vector<WorkerTrace> getLocalTrace();
+HPX_DEFINE_PLAIN_ACTION(getLocalTrace, getLocalTrace_act);
+
+// Gather every locality's trace into fileName (on the calling locality)
+void writeChromeTrace(const std::string & fileName);
+
+}}
+
+HPX_REGISTER_ACTION_DECLARATION(YewPar::Trace::getLocalTrace_act, yewpar_trace_get_local_trace_act);
+
+#endif
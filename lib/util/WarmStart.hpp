@@ -0,0 +1,93 @@
+#ifndef YEWPAR_WARMSTART_HPP
+#define YEWPAR_WARMSTART_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <hpx/include/async.hpp>
+#include <hpx/lcos/broadcast.hpp>
+#include <hpx/lcos/wait_all.hpp>
+#include <hpx/runtime/actions/basic_action.hpp>
+#include <hpx/runtime/get_locality_id.hpp>
+#include <hpx/runtime/get_os_thread_count.hpp>
+
+#include "skeletons/API.hpp"
+#include "util/func.hpp"
+
+namespace YewPar {
+
+// Warm start (see API::WarmStart). On one locality: every worker calls the
+// heuristic with fresh seeds until the time slice is spent (always at least
+// once) and the best node found is returned. Seeds differ between workers,
+// localities and calls.
+template <typename Space, typename Node, typename Cmp, typename Heuristic>
+Node runWarmStart(Space space, Node root, std::uint64_t timeMs) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeMs);
+  auto workers = hpx::get_os_thread_count();
+  std::uint64_t locality = hpx::get_locality_id();
+
+  std::vector<hpx::future<Node> > results;
+  for (auto w = 0u; w < workers; ++w) {
+    results.push_back(hpx::async([&, w]() {
+      Cmp cmp;
+      std::uint64_t seed = (locality << 48) | (static_cast<std::uint64_t>(w) << 32);
+      auto best = Heuristic::invoke(space, root, seed);
+      while (std::chrono::steady_clock::now() < deadline) {
+        auto n = Heuristic::invoke(space, root, ++seed);
+        if (cmp(n.getObj(), best.getObj())) {
+          best = n;
+        }
+      }
+      return best;
+    }));
+  }
+  hpx::wait_all(results);
+
+  Cmp cmp;
+  auto best = results[0].get();
+  for (auto i = 1u; i < results.size(); ++i) {
+    auto n = results[i].get();
+    if (cmp(n.getObj(), best.getObj())) {
+      best = n;
+    }
+  }
+  return best;
+}
+
+template <typename Space, typename Node, typename Cmp, typename Heuristic>
+struct WarmStartAct : hpx::actions::make_action<
+  decltype(&runWarmStart<Space, Node, Cmp, Heuristic>), &runWarmStart<Space, Node, Cmp, Heuristic>, WarmStartAct<Space, Node, Cmp, Heuristic> >::type {};
+
+// Run the warm start on every locality for params.warmStartTime ms before a
+// search. If the best node found beats params.initialBound it becomes the
+// initial bound and the node is returned to seed the incumbent, otherwise
+// (or without a heuristic) the root is.
+template <typename Space, typename Node, typename Bound, typename Cmp, typename Heuristic>
+Node warmStart(const Space & space, const Node & root, Skeletons::API::Params<Bound> & params) {
+  if constexpr(std::is_same<Heuristic, nullFn__>::value) {
+    return root;
+  } else {
+    if (params.warmStartTime == 0) {
+      return root;
+    }
+
+    auto found = hpx::lcos::broadcast<WarmStartAct<Space, Node, Cmp, Heuristic> >(
+        hpx::find_all_localities(), space, root, params.warmStartTime).get();
+
+    Cmp cmp;
+    auto best = root;
+    for (const auto & n : found) {
+      if (cmp(n.getObj(), params.initialBound)) {
+        best = n;
+        params.initialBound = n.getObj();
+      }
+    }
+    return best;
+  }
+}
+
+}
+
+#endif
@@ -52,6 +52,14 @@ void DepthPool::addWork(DepthPool::fnType task, unsigned depth) {
   }
 }
 
+std::vector<std::uint64_t> DepthPool::sizes() {
+  std::vector<std::uint64_t> res;
+  for (auto i = 0; i <= lowest; ++i) {
+    res.push_back(pools[i].size());
+  }
+  return res;
+}
+
 }
 
 HPX_REGISTER_COMPONENT_MODULE();
@@ -63,3 +71,4 @@ HPX_REGISTER_COMPONENT(DepthPool_type, DepthPool);
 HPX_REGISTER_ACTION(workstealing::DepthPool::getLocal_action, DepthPool_getLocal_action);
 HPX_REGISTER_ACTION(workstealing::DepthPool::steal_action, DepthPool_steal_action);
 HPX_REGISTER_ACTION(workstealing::DepthPool::addWork_action, DepthPool_addWork_action);
+HPX_REGISTER_ACTION(workstealing::DepthPool::sizes_action, DepthPool_sizes_action);
@@ -1,7 +1,9 @@
 #ifndef DEPTHPOOL_COMPONENT_HPP
 #define DEPTHPOOL_COMPONENT_HPP
 
+#include <cstdint>
 #include <queue>
+#include <vector>
 
 #include <hpx/include/components.hpp>
 #include <hpx/util/lockfree/deque.hpp>
@@ -40,11 +42,15 @@ class DepthPool : public hpx::components::locking_hook<
   HPX_DEFINE_COMPONENT_ACTION(DepthPool, steal);
   void addWork(fnType task, unsigned depth);
   HPX_DEFINE_COMPONENT_ACTION(DepthPool, addWork);
+  // Number of tasks at each depth, up to the deepest non-empty one
+  std::vector<std::uint64_t> sizes();
+  HPX_DEFINE_COMPONENT_ACTION(DepthPool, sizes);
 };
 }
 
 HPX_REGISTER_ACTION_DECLARATION(workstealing::DepthPool::getLocal_action, DepthPool_getLocal_action);
 HPX_REGISTER_ACTION_DECLARATION(workstealing::DepthPool::steal_action, DepthPool_steal_action);
 HPX_REGISTER_ACTION_DECLARATION(workstealing::DepthPool::addWork_action, DepthPool_addWork_action);
+HPX_REGISTER_ACTION_DECLARATION(workstealing::DepthPool::sizes_action, DepthPool_sizes_action);
 
 #endif
@@ -2,12 +2,31 @@
 #include "hpx/runtime/actions/plain_action.hpp"
 #include "hpx/runtime/naming/id_type.hpp"
 #include "hpx/runtime/threads/executors/default_executor.hpp"
+#include "hpx/runtime/get_os_thread_count.hpp"
+#include "hpx/runtime/get_worker_thread_num.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
 #include "Scheduler.hpp"
 #include "ExponentialBackoff.hpp"
+#include "util/Trace.hpp"
 
 namespace Workstealing { namespace Scheduler {
 
+namespace {
+// One slot per worker thread, plus one for anything else
+std::unique_ptr<std::atomic<std::uint64_t>[]> idleTimes;
+std::size_t numIdleSlots = 0;
+
+void addIdleTime(std::chrono::steady_clock::duration d) {
+  auto worker = std::min<std::size_t>(hpx::get_worker_thread_num(), numIdleSlots - 1);
+  idleTimes[worker].fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(d).count(),
+                              std::memory_order_relaxed);
+}
+}
+
 void scheduler(hpx::util::function<void(), false> initialTask) {
   workstealing::ExponentialBackoff backoff;
 
@@ -26,6 +45,11 @@ void scheduler(hpx::util::function<void(), false> initialTask) {
     initialTask();
   }
 
+  // Idle time is only measured while there is no work, so the clock isn't
+  // read between tasks
+  bool idle = false;
+  std::chrono::steady_clock::time_point idleSince;
+
   for (;;) {
     if (!running) {
       break;
@@ -34,11 +58,28 @@ void scheduler(hpx::util::function<void(), false> initialTask) {
     auto task = local_policy->getWork();
 
     if (task) {
+      if (idle) {
+        addIdleTime(std::chrono::steady_clock::now() - idleSince);
+        idle = false;
+        YewPar::Trace::record(YewPar::Trace::Event::IdleEnd);
+      }
       backoff.reset();
+      YewPar::Trace::record(YewPar::Trace::Event::TaskStart);
       task();
+      YewPar::Trace::record(YewPar::Trace::Event::TaskEnd);
     } else {
+      if (!idle) {
+        idle = true;
+        idleSince = std::chrono::steady_clock::now();
+        YewPar::Trace::record(YewPar::Trace::Event::IdleStart);
+      }
       backoff.failed();
       hpx::this_thread::suspend(backoff.getSleepTime());
+
+      // Keep the totals current for anyone reporting progress
+      auto now = std::chrono::steady_clock::now();
+      addIdleTime(now - idleSince);
+      idleSince = now;
     }
   }
 
@@ -62,6 +103,16 @@ void stopSchedulers() {
 }
 
 void startSchedulers(unsigned n) {
+  auto slots = hpx::get_os_thread_count() + 1;
+  if (numIdleSlots != slots) {
+    idleTimes = std::make_unique<std::atomic<std::uint64_t>[]>(slots);
+    numIdleSlots = slots;
+  }
+  for (auto i = 0; i < numIdleSlots; ++i) {
+    idleTimes[i] = 0;
+  }
+  YewPar::Trace::reset();
+
   hpx::threads::executors::default_executor exe(hpx::threads::thread_priority_critical,
                                                 hpx::threads::thread_stacksize_huge);
 
@@ -70,4 +121,13 @@ void startSchedulers(unsigned n) {
   }
 }
 
+std::vector<std::uint64_t> getIdleTimes() {
+  std::vector<std::uint64_t> res;
+  // Don't report the slot for non-worker threads
+  for (auto i = 0; i + 1 < numIdleSlots; ++i) {
+    res.push_back(idleTimes[i].load(std::memory_order_relaxed));
+  }
+  return res;
+}
+
 }}
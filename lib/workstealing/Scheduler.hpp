@@ -2,6 +2,8 @@
 #define YEWPAR_SCHEDULER_HPP
 
 #include <atomic>
+#include <cstdint>
+#include <vector>
 #include "hpx/runtime/actions/plain_action.hpp"
 #include "policies/Policy.hpp"
 #include "hpx/lcos/local/mutex.hpp"
@@ -28,6 +30,10 @@ void scheduler(hpx::util::function<void(), false> initialTask);
 void startSchedulers(unsigned n);
 HPX_DEFINE_PLAIN_ACTION(startSchedulers, startSchedulers_act);
 
+// Time (in microseconds) each worker thread has spent in the scheduler
+// without work since the schedulers were last started
+std::vector<std::uint64_t> getIdleTimes();
+
 }} // Workstealing::Scheduler
 
 
@@ -22,6 +22,7 @@ namespace workstealing
     if (!tasks.pop_right(task)) {
       return nullptr;
     }
+    --numTasks;
     return task;
   }
 
@@ -30,12 +31,19 @@ namespace workstealing
     if (!tasks.pop_left(task)) {
       return nullptr;
     }
+    --numTasks;
     return task;
   }
 
   void Workqueue::addWork(funcType task) {
+    ++numTasks;
     tasks.push_left(task);
   }
+
+  std::uint64_t Workqueue::size() {
+    auto n = numTasks.load();
+    return n > 0 ? n : 0;
+  }
 }
 HPX_REGISTER_COMPONENT_MODULE();
 
@@ -46,3 +54,4 @@ HPX_REGISTER_COMPONENT(Workqueue_type, Workqueue);
 HPX_REGISTER_ACTION(workstealing::Workqueue::getLocal_action, Workqueue_getLocal_action);
 HPX_REGISTER_ACTION(workstealing::Workqueue::steal_action, Workqueue_steal_action);
 HPX_REGISTER_ACTION(workstealing::Workqueue::addWork_action, Workqueue_addWork_action);
+HPX_REGISTER_ACTION(workstealing::Workqueue::size_action, Workqueue_size_action);
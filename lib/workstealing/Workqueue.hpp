@@ -1,6 +1,9 @@
 #ifndef WORKQUEUE_COMPONENT_HPP
 #define WORKQUEUE_COMPONENT_HPP
 
+#include <atomic>
+#include <cstdint>
+
 #include <hpx/util/lockfree/deque.hpp>                           // for deque
 #include "hpx/runtime/actions/basic_action.hpp"                  // for HPX_...
 #include "hpx/runtime/actions/component_action.hpp"              // for HPX_...
@@ -21,6 +24,10 @@ namespace workstealing
       using funcType = hpx::util::function<void(hpx::naming::id_type)>;
       boost::lockfree::deque<funcType> tasks; // From HPX
 
+      // The deque can't report its size so track it separately. Only
+      // approximate while tasks are being added/removed.
+      std::atomic<std::int64_t> numTasks {0};
+
     public:
       funcType getLocal();
       HPX_DEFINE_COMPONENT_ACTION(Workqueue, getLocal);
@@ -28,11 +35,14 @@ namespace workstealing
       HPX_DEFINE_COMPONENT_ACTION(Workqueue, steal);
       void addWork(funcType task);
       HPX_DEFINE_COMPONENT_ACTION(Workqueue, addWork);
+      std::uint64_t size();
+      HPX_DEFINE_COMPONENT_ACTION(Workqueue, size);
     };
 }
 
 HPX_REGISTER_ACTION_DECLARATION(workstealing::Workqueue::getLocal_action, Workqueue_getLocal_action);
 HPX_REGISTER_ACTION_DECLARATION(workstealing::Workqueue::steal_action, Workqueue_steal_action);
 HPX_REGISTER_ACTION_DECLARATION(workstealing::Workqueue::addWork_action, Workqueue_addWork_action);
+HPX_REGISTER_ACTION_DECLARATION(workstealing::Workqueue::size_action, Workqueue_size_action);
 
 #endif
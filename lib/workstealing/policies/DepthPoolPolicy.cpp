@@ -6,21 +6,23 @@
 
 #include <memory>
 
+#include "util/ShardedCounter.hpp"
+#include "util/Trace.hpp"
 #include "util/util.hpp"
 
 namespace Workstealing { namespace Policies {
 
 namespace DepthPoolPolicyPerf {
 
-std::atomic<std::uint64_t> perf_spawns(0);
-std::atomic<std::uint64_t> perf_localSteals(0);
-std::atomic<std::uint64_t> perf_distributedSteals(0);
-std::atomic<std::uint64_t> perf_failedLocalSteals(0);
-std::atomic<std::uint64_t> perf_failedDistributedSteals(0);
+YewPar::util::ShardedCounter perf_spawns;
+YewPar::util::ShardedCounter perf_localSteals;
+YewPar::util::ShardedCounter perf_distributedSteals;
+YewPar::util::ShardedCounter perf_failedLocalSteals;
+YewPar::util::ShardedCounter perf_failedDistributedSteals;
 
-std::uint64_t get_and_reset(std::atomic<std::uint64_t> & cntr, bool reset) {
+std::uint64_t get_and_reset(YewPar::util::ShardedCounter & cntr, bool reset) {
   auto res = cntr.load();
-  if (reset) { cntr = 0; }
+  if (reset) { cntr.reset(); }
   return res;
 }
 
@@ -80,9 +82,11 @@ hpx::util::function<void(), false> DepthPoolPolicy::getWork() {
 
   if (task) {
     DepthPoolPolicyPerf::perf_localSteals++;
+    YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, -1);
     return hpx::util::bind(task, hpx::find_here());
   } else {
     DepthPoolPolicyPerf::perf_failedLocalSteals++;
+    YewPar::Trace::record(YewPar::Trace::Event::StealFailed, -1);
   }
 
   if (!distributed_workpools.empty()) {
@@ -91,9 +95,11 @@ hpx::util::function<void(), false> DepthPoolPolicy::getWork() {
       task = hpx::async<workstealing::DepthPool::steal_action>(last_remote).get();
       if (task) {
         DepthPoolPolicyPerf::perf_distributedSteals++;
+        YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(last_remote));
         return hpx::util::bind(task, hpx::find_here());
       } else {
         DepthPoolPolicyPerf::perf_failedDistributedSteals++;
+        YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(last_remote));
         last_remote = hpx::find_here();
       }
     }
@@ -107,9 +113,11 @@ hpx::util::function<void(), false> DepthPoolPolicy::getWork() {
     if (task) {
       last_remote = *victim;
       DepthPoolPolicyPerf::perf_distributedSteals++;
+      YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(*victim));
       return hpx::util::bind(task, hpx::find_here());
     } else {
       DepthPoolPolicyPerf::perf_failedDistributedSteals++;
+      YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(*victim));
     }
   }
 
@@ -119,6 +127,7 @@ hpx::util::function<void(), false> DepthPoolPolicy::getWork() {
 void DepthPoolPolicy::addwork(hpx::util::function<void(hpx::naming::id_type)> task, unsigned depth) {
   std::unique_lock<mutex_t> l(mtx);
   DepthPoolPolicyPerf::perf_spawns++;
+  YewPar::Trace::record(YewPar::Trace::Event::Spawn);
   hpx::apply<workstealing::DepthPool::addWork_action>(local_workpool, task, depth);
 }
 
@@ -130,4 +139,17 @@ void DepthPoolPolicy::registerDistributedDepthPools(std::vector<hpx::naming::id_
       distributed_workpools.end());
 }
 
+std::vector<std::uint64_t> DepthPoolPolicy::poolSizes() {
+  return hpx::async<workstealing::DepthPool::sizes_action>(local_workpool).get();
+}
+
+StealStats DepthPoolPolicy::stealStats() {
+  StealStats s;
+  s.localSteals = DepthPoolPolicyPerf::perf_localSteals.load();
+  s.failedLocalSteals = DepthPoolPolicyPerf::perf_failedLocalSteals.load();
+  s.distributedSteals = DepthPoolPolicyPerf::perf_distributedSteals.load();
+  s.failedDistributedSteals = DepthPoolPolicyPerf::perf_failedDistributedSteals.load();
+  return s;
+}
+
 }}
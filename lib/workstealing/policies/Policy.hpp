@@ -1,12 +1,37 @@
 #ifndef YEWPAR_POLICY_HPP
 #define YEWPAR_POLICY_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include <hpx/util/function.hpp>
 
+// Steal attempts made by a policy since startup (the same values as its
+// performance counters)
+struct StealStats {
+  std::uint64_t localSteals = 0;
+  std::uint64_t failedLocalSteals = 0;
+  std::uint64_t distributedSteals = 0;
+  std::uint64_t failedDistributedSteals = 0;
+
+  template <class Archive>
+  void serialize(Archive & ar, const unsigned int version) {
+    ar & localSteals;
+    ar & failedLocalSteals;
+    ar & distributedSteals;
+    ar & failedDistributedSteals;
+  }
+};
+
 class Policy {
  public:
   // Scheduler hook point
   virtual hpx::util::function<void(), false> getWork() = 0;
+
+  // Progress reporting hooks. Number of tasks waiting in the local pool, per
+  // depth for depth aware pools. Empty if the policy has no pool.
+  virtual std::vector<std::uint64_t> poolSizes() { return {}; }
+  virtual StealStats stealStats() { return {}; }
 };
 
 #endif
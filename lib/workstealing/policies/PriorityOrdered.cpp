@@ -4,13 +4,13 @@
 
 namespace Workstealing { namespace Policies { namespace PriorityOrderedPerf {
 
-std::atomic<std::uint64_t> perf_spawns(0);
-std::atomic<std::uint64_t> perf_steals(0);
-std::atomic<std::uint64_t> perf_failedSteals(0);
+YewPar::util::ShardedCounter perf_spawns;
+YewPar::util::ShardedCounter perf_steals;
+YewPar::util::ShardedCounter perf_failedSteals;
 
-std::uint64_t get_and_reset(std::atomic<std::uint64_t> & cntr, bool reset) {
+std::uint64_t get_and_reset(YewPar::util::ShardedCounter & cntr, bool reset) {
   auto res = cntr.load();
-  if (reset) { cntr = 0; }
+  if (reset) { cntr.reset(); }
   return res;
 }
 
@@ -7,6 +7,8 @@
 #include <hpx/lcos/local/mutex.hpp>
 
 #include "Policy.hpp"
+#include "util/ShardedCounter.hpp"
+#include "util/Trace.hpp"
 #include "workstealing/PriorityWorkqueue.hpp"
 
 namespace Workstealing { namespace Scheduler {extern std::shared_ptr<Policy> local_policy; }}
@@ -15,9 +17,9 @@ namespace Workstealing { namespace Policies {
 
 namespace PriorityOrderedPerf {
 
-extern std::atomic<std::uint64_t> perf_spawns;
-extern std::atomic<std::uint64_t> perf_steals;
-extern std::atomic<std::uint64_t> perf_failedSteals;
+extern YewPar::util::ShardedCounter perf_spawns;
+extern YewPar::util::ShardedCounter perf_steals;
+extern YewPar::util::ShardedCounter perf_failedSteals;
 
 void registerPerformanceCounters();
 
@@ -42,16 +44,26 @@ class PriorityOrderedPolicy : public Policy {
     task = hpx::async<workstealing::PriorityWorkqueue::steal_action>(globalWorkqueue).get();
     if (task) {
       PriorityOrderedPerf::perf_steals++;
+      YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(globalWorkqueue));
       return hpx::util::bind(task, hpx::find_here());
     }
 
     PriorityOrderedPerf::perf_failedSteals++;
+    YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(globalWorkqueue));
     return nullptr;
   }
 
+  StealStats stealStats() override {
+    StealStats s;
+    s.distributedSteals = PriorityOrderedPerf::perf_steals.load();
+    s.failedDistributedSteals = PriorityOrderedPerf::perf_failedSteals.load();
+    return s;
+  }
+
   void addwork(int priority, hpx::util::function<void(hpx::naming::id_type)> task) {
     std::unique_lock<mutex_t> l(mtx);
     PriorityOrderedPerf::perf_spawns++;
+    YewPar::Trace::record(YewPar::Trace::Event::Spawn);
     hpx::apply<workstealing::PriorityWorkqueue::addWork_action>(globalWorkqueue, priority, task);
   }
 
@@ -9,9 +9,9 @@ HPX_REGISTER_COMPONENT_MODULE();
 
 namespace Workstealing { namespace Policies { namespace SearchManagerPerf {
 
-std::uint64_t get_and_reset(std::atomic<std::uint64_t> & cntr, bool reset) {
+std::uint64_t get_and_reset(YewPar::util::ShardedCounter & cntr, bool reset) {
   auto res = cntr.load();
-  if (reset) { cntr = 0; }
+  if (reset) { cntr.reset(); }
   return res;
 }
 
@@ -46,6 +46,8 @@
 #include "hpx/util/lockfree/deque.hpp"
 
 #include "Policy.hpp"
+#include "util/ShardedCounter.hpp"
+#include "util/Trace.hpp"
 #include "util/util.hpp"
 
 namespace Workstealing { namespace Scheduler {extern std::shared_ptr<Policy> local_policy; }}
@@ -54,10 +56,10 @@ namespace Workstealing { namespace Policies {
 
 namespace SearchManagerPerf {
 // Performance Counters
-std::atomic<std::uint64_t> perf_localSteals(0);
-std::atomic<std::uint64_t> perf_distributedSteals(0);
-std::atomic<std::uint64_t> perf_failedLocalSteals(0);
-std::atomic<std::uint64_t> perf_failedDistributedSteals(0);
+YewPar::util::ShardedCounter perf_localSteals;
+YewPar::util::ShardedCounter perf_distributedSteals;
+YewPar::util::ShardedCounter perf_failedLocalSteals;
+YewPar::util::ShardedCounter perf_failedDistributedSteals;
 
 std::vector<std::pair<hpx::naming::id_type, bool> > distributedStealsList;
 
@@ -173,9 +175,11 @@ struct SearchManager : public hpx::components::component_base<SearchManager> {
 
       if (!res.empty()) {
         SearchManagerPerf::distributedStealsList.push_back(std::make_pair(victim, true));
+        YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(victim));
         last_remote = victim;
       } else {
         SearchManagerPerf::distributedStealsList.push_back(std::make_pair(victim, false));
+        YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(victim));
         last_remote = hpx::find_here();
       }
 
@@ -249,6 +253,15 @@ struct SearchManager : public hpx::components::component_base<SearchManager> {
       return res;
     }
 
+    StealStats stealStats() override {
+      StealStats s;
+      s.localSteals = SearchManagerPerf::perf_localSteals.load();
+      s.failedLocalSteals = SearchManagerPerf::perf_failedLocalSteals.load();
+      s.distributedSteals = SearchManagerPerf::perf_distributedSteals.load();
+      s.failedDistributedSteals = SearchManagerPerf::perf_failedDistributedSteals.load();
+      return s;
+    }
+
     // Called by the scheduler to ask the searchManager to add more work
     hpx::util::function<void(), false> getWork() override {
       std::unique_lock<MutexT> l(mtx);
@@ -274,14 +287,17 @@ struct SearchManager : public hpx::components::component_base<SearchManager> {
           }
         } else {
           SearchManagerPerf::perf_failedLocalSteals++;
+          YewPar::Trace::record(YewPar::Trace::Event::StealFailed, -1);
           return nullptr;
         }
       } else {
         maybeStolen = getLocalWork(l);
         if (!maybeStolen.empty()) {
           SearchManagerPerf::perf_localSteals++;
+          YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, -1);
         } else {
           SearchManagerPerf::perf_failedLocalSteals++;
+          YewPar::Trace::record(YewPar::Trace::Event::StealFailed, -1);
           return nullptr;
         }
       }
@@ -6,21 +6,23 @@
 
 #include <memory>
 
+#include "util/ShardedCounter.hpp"
+#include "util/Trace.hpp"
 #include "util/util.hpp"
 
 namespace Workstealing { namespace Policies {
 
 namespace WorkpoolPerf {
 
-std::atomic<std::uint64_t> perf_spawns(0);
-std::atomic<std::uint64_t> perf_localSteals(0);
-std::atomic<std::uint64_t> perf_distributedSteals(0);
-std::atomic<std::uint64_t> perf_failedLocalSteals(0);
-std::atomic<std::uint64_t> perf_failedDistributedSteals(0);
+YewPar::util::ShardedCounter perf_spawns;
+YewPar::util::ShardedCounter perf_localSteals;
+YewPar::util::ShardedCounter perf_distributedSteals;
+YewPar::util::ShardedCounter perf_failedLocalSteals;
+YewPar::util::ShardedCounter perf_failedDistributedSteals;
 
-std::uint64_t get_and_reset(std::atomic<std::uint64_t> & cntr, bool reset) {
+std::uint64_t get_and_reset(YewPar::util::ShardedCounter & cntr, bool reset) {
   auto res = cntr.load();
-  if (reset) { cntr = 0; }
+  if (reset) { cntr.reset(); }
   return res;
 }
 
@@ -81,9 +83,11 @@ hpx::util::function<void(), false> Workpool::getWork() {
 
   if (task) {
     WorkpoolPerf::perf_localSteals++;
+    YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, -1);
     return hpx::util::bind(task, hpx::find_here());
   } else {
     WorkpoolPerf::perf_failedLocalSteals++;
+    YewPar::Trace::record(YewPar::Trace::Event::StealFailed, -1);
   }
 
   if (!distributed_workqueues.empty()) {
@@ -92,9 +96,11 @@ hpx::util::function<void(), false> Workpool::getWork() {
       task = hpx::async<workstealing::Workqueue::steal_action>(last_remote).get();
       if (task) {
         WorkpoolPerf::perf_distributedSteals++;
+        YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(last_remote));
         return hpx::util::bind(task, hpx::find_here());
       } else {
         WorkpoolPerf::perf_failedDistributedSteals++;
+        YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(last_remote));
         last_remote = hpx::find_here();
       }
     }
@@ -108,9 +114,11 @@ hpx::util::function<void(), false> Workpool::getWork() {
     if (task) {
       last_remote = *victim;
       WorkpoolPerf::perf_distributedSteals++;
+      YewPar::Trace::record(YewPar::Trace::Event::StealSuccess, YewPar::Trace::victimLocality(*victim));
       return hpx::util::bind(task, hpx::find_here());
     } else {
       WorkpoolPerf::perf_failedDistributedSteals++;
+      YewPar::Trace::record(YewPar::Trace::Event::StealFailed, YewPar::Trace::victimLocality(*victim));
     }
   }
 
@@ -120,6 +128,7 @@ hpx::util::function<void(), false> Workpool::getWork() {
 void Workpool::addwork(hpx::util::function<void(hpx::naming::id_type)> task) {
   std::unique_lock<mutex_t> l(mtx);
   WorkpoolPerf::perf_spawns++;
+  YewPar::Trace::record(YewPar::Trace::Event::Spawn);
   hpx::apply<workstealing::Workqueue::addWork_action>(local_workqueue, task);
 }
 
@@ -131,4 +140,17 @@ void Workpool::registerDistributedWorkqueues(std::vector<hpx::naming::id_type> w
       distributed_workqueues.end());
 }
 
+std::vector<std::uint64_t> Workpool::poolSizes() {
+  return {hpx::async<workstealing::Workqueue::size_action>(local_workqueue).get()};
+}
+
+StealStats Workpool::stealStats() {
+  StealStats s;
+  s.localSteals = WorkpoolPerf::perf_localSteals.load();
+  s.failedLocalSteals = WorkpoolPerf::perf_failedLocalSteals.load();
+  s.distributedSteals = WorkpoolPerf::perf_distributedSteals.load();
+  s.failedDistributedSteals = WorkpoolPerf::perf_failedDistributedSteals.load();
+  return s;
+}
+
 }}
@@ -46,6 +46,9 @@ class Workpool : public Policy {
 
   hpx::util::function<void(), false> getWork() override;
 
+  std::vector<std::uint64_t> poolSizes() override;
+  StealStats stealStats() override;
+
   void addwork(hpx::util::function<void(hpx::naming::id_type)> task);
 
   void registerDistributedWorkqueues(std::vector<hpx::naming::id_type> workqueues);